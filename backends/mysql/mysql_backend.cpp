@@ -5,6 +5,8 @@
 #include <edba/detail/utils.hpp>
 
 #include <boost/scope_exit.hpp>
+#include <boost/foreach.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 
 #include <iostream>
 #include <sstream>
@@ -36,13 +38,19 @@ namespace unprep {
 class result : public backend::result, public boost::static_visitor<bool>
 {
 public:
-    result(MYSQL *conn) :
-        res_(0)
+    ///
+    /// Streamed result reads rows from connection one by one with mysql_use_result, connection can`t be used
+    /// for other queries until the result is destroyed. Remaining rows are discarded on destruction.
+    ///
+    result(MYSQL *conn, bool streaming = false) :
+        conn_(conn)
+      , res_(0)
       , cols_(0)
       , current_row_(0)
       , row_(0)
+      , streaming_(streaming)
     {
-        res_ = mysql_store_result(conn);
+        res_ = streaming_ ? mysql_use_result(conn) : mysql_store_result(conn);
         if(!res_) {
             cols_ = mysql_field_count(conn);
             if(cols_ == 0)
@@ -63,6 +71,8 @@ public:
     {
         if(!res_)
             return last_row_reached;
+        if(streaming_)
+            return next_row_unknown;
         if(current_row_ >= mysql_num_rows(res_))
             return last_row_reached;
         else
@@ -75,8 +85,12 @@ public:
             return false;
         current_row_ ++;
         row_ = mysql_fetch_row(res_);
-        if(!row_)
+        if(!row_) {
+            // Streamed rows are read from network, so end of rows can be caused by an error
+            if(streaming_ && mysql_errno(conn_))
+                throw edba_myerror(mysql_error(conn_));
             return false;
+        }
         return true;
     }
 
@@ -140,6 +154,8 @@ public:
 
     virtual boost::uint64_t rows()
     {
+        if(streaming_)
+            return boost::uint64_t(-1);
         return boost::uint64_t(mysql_num_rows(res_));
     }
 
@@ -193,21 +209,24 @@ private:
         return row_[col];
     }
 
+    MYSQL *conn_;
     MYSQL_RES *res_;
     int cols_;
     unsigned current_row_;
     int fetch_col_;
     MYSQL_ROW row_;
+    bool streaming_;
 };
 
 class statement : public backend::statement, public boost::static_visitor<>
 {
 public:
-    statement(const string_ref& q, MYSQL *conn, session_stat* stat)
+    statement(const string_ref& q, MYSQL *conn, session_stat* stat, bool stream_results = false)
       : backend::statement(stat)
       , bind_by_name_helper_(q, detail::question_marker())
       , conn_(conn)
       , params_no_(0)
+      , stream_results_(stream_results)
     {
         fmt_.imbue(std::locale::classic());
         bool inside_text = false;
@@ -314,7 +333,7 @@ public:
         if(mysql_real_query(conn_,real_query.c_str(),real_query.size())) {
             throw edba_myerror(mysql_error(conn_));
         }
-        return new result(conn_);
+        return new result(conn_, stream_results_ || streamed_result == result_mode_);
     }
 
     virtual void exec_impl()
@@ -333,7 +352,138 @@ public:
         }
     }
 
+    ///
+    /// Rewrite INSERT ... VALUES(?, ...) into multi row insert, so the whole batch is sent in few requests.
+    /// Other statements are executed row by row.
+    ///
+    virtual unsigned long long exec_many_impl(const backend::bind_rows& rows)
+    {
+        size_t open, close;
+        if (rows.rows() < 2 || !find_values_tuple(open, close))
+            return backend::statement::exec_many_impl(rows);
+
+        // Stay well below default max_allowed_packet
+        const size_t max_query_size = 1024 * 1024;
+
+        const std::string& patched_sql = patched_query();
+        unsigned long long affected_total = 0;
+        std::string real_query;
+        bool first_tuple = true;
+
+        for(size_t r = 0; r < rows.rows(); ++r)
+        {
+            bind_row(rows, r);
+
+            if (first_tuple)
+                real_query.assign(patched_sql, 0, open);
+            else
+                real_query += ',';
+
+            append_bound(real_query, open, close + 1);
+            reset_params();
+            first_tuple = false;
+
+            if (real_query.size() >= max_query_size || r + 1 == rows.rows())
+            {
+                real_query.append(patched_sql, close + 1, std::string::npos);
+
+                if(mysql_real_query(conn_, real_query.c_str(), real_query.size()))
+                    throw edba_myerror(mysql_error(conn_));
+
+                affected_total += mysql_affected_rows(conn_);
+                first_tuple = true;
+            }
+        }
+
+        return affected_total;
+    }
+
 private:
+    /// Find position of parentheses around the row of INSERT ... VALUES(...) statement. Return false if the statement
+    /// has another form or has parameters outside of values row.
+    bool find_values_tuple(size_t& open, size_t& close)
+    {
+        const std::string& sql = patched_query();
+
+        if (binders_.empty())
+            return false;
+
+        size_t start = sql.find_first_not_of(" \t\r\n");
+        if (start == std::string::npos)
+            return false;
+
+        string_ref trimmed(sql.c_str() + start, sql.c_str() + sql.size());
+        if (!boost::algorithm::istarts_with(trimmed, "insert") && !boost::algorithm::istarts_with(trimmed, "replace"))
+            return false;
+
+        // Find VALUES keyword outside of text
+        size_t values_pos = std::string::npos;
+        bool inside_text = false;
+        for(size_t i = start; i + 6 <= sql.size(); ++i)
+        {
+            if (sql[i] == '\'')
+                inside_text = !inside_text;
+
+            if (!inside_text
+                && (i == 0 || !isalnum((unsigned char)sql[i - 1]))
+                && boost::algorithm::iequals(string_ref(sql.c_str() + i, sql.c_str() + i + 6), "values")
+                && (i + 6 == sql.size() || !isalnum((unsigned char)sql[i + 6])))
+            {
+                values_pos = i + 6;
+                break;
+            }
+        }
+
+        if (values_pos == std::string::npos)
+            return false;
+
+        open = sql.find_first_not_of(" \t\r\n", values_pos);
+        if (open == std::string::npos || sql[open] != '(')
+            return false;
+
+        // Find matching parenthesis
+        int depth = 0;
+        inside_text = false;
+        for(close = open; close < sql.size(); ++close)
+        {
+            if (sql[close] == '\'')
+                inside_text = !inside_text;
+            else if (!inside_text && sql[close] == '(')
+                ++depth;
+            else if (!inside_text && sql[close] == ')' && --depth == 0)
+                break;
+        }
+
+        if (close == sql.size())
+            return false;
+
+        // Statement already inserts multiple rows
+        size_t next = sql.find_first_not_of(" \t\r\n", close + 1);
+        if (next != std::string::npos && sql[next] == ',')
+            return false;
+
+        return binders_.front() > open && binders_.back() < close;
+    }
+
+    /// Append part [from, to) of patched query with markers replaced by bound values
+    void append_bound(std::string& real_query, size_t from, size_t to)
+    {
+        const std::string& patched_sql = patched_query();
+
+        size_t pos = from;
+        for(unsigned i = 0; i < params_.size(); i++)
+        {
+            size_t marker = binders_[i];
+            if (marker < from || marker >= to)
+                continue;
+
+            real_query.append(patched_sql, pos, marker - pos);
+            real_query.append(params_[i]);
+            pos = marker + 1;
+        }
+        real_query.append(patched_sql, pos, to - pos);
+    }
+
     std::string &at(int col)
     {
         if(col < 1 || col > params_no_)
@@ -376,6 +526,7 @@ private:
     detail::bind_by_name_helper bind_by_name_helper_;
     MYSQL *conn_;
     int params_no_;
+    bool stream_results_;   // @mysql_stream=on
     int bind_col_;
 };
 
@@ -385,14 +536,24 @@ namespace prep {
 
 class result : public backend::result, public boost::static_visitor<bool>
 {
+    ///
+    /// Column is bound once with its native type, numbers and time are fetched without text conversion
+    ///
     struct bind_data
     {
-        bind_data() : ptr(0), length(0), is_null(0), error(0)
+        bind_data() : type(MYSQL_TYPE_STRING), is_unsigned(0), decimals(0), integer(0), floating(0), floating4(0), ptr(0), length(0), is_null(0), error(0)
         {
-            memset(&buf,0,sizeof(buf));
+            memset(&time,0,sizeof(time));
         }
 
-        char buf[128];
+        enum_field_types type;
+        my_bool is_unsigned;
+        unsigned decimals;
+        long long integer;
+        double floating;
+        float floating4;
+        MYSQL_TIME time;
+        std::vector<char> buf;
         std::vector<char> vbuf;
         char *ptr;
         unsigned long length;
@@ -401,23 +562,46 @@ class result : public backend::result, public boost::static_visitor<bool>
     };
 
 public:
-    result(MYSQL_STMT *stmt) 
+    ///
+    /// Streamed result doesn`t call mysql_stmt_store_result and fetches rows from network one by one,
+    /// remaining rows are discarded on destruction.
+    ///
+    result(MYSQL_STMT *stmt, bool streaming = false) 
       : stmt_(stmt)
       , current_row_(0)
       , meta_(0)
+      , fetched_(false)
+      , streaming_(streaming)
     {
         cols_ = mysql_stmt_field_count(stmt_);
-        if(mysql_stmt_store_result(stmt_)) {
-            throw edba_myerror(mysql_stmt_error(stmt_));
+
+        if(!streaming_) {
+            // Let client compute maximal length of each column, so buffers could be allocated without truncation
+            my_bool update_max_length = 1;
+            mysql_stmt_attr_set(stmt_, STMT_ATTR_UPDATE_MAX_LENGTH, &update_max_length);
+
+            if(mysql_stmt_store_result(stmt_)) {
+                throw edba_myerror(mysql_stmt_error(stmt_));
+            }
         }
         meta_ = mysql_stmt_result_metadata(stmt_);
         if(!meta_) {
             throw edba_myerror("Seems that the query does not produce any result");
         }
+
+        try {
+            bind_columns();
+        }
+        catch(...) {
+            mysql_free_result(meta_);
+            throw;
+        }
     }
     ~result()
     {
         mysql_free_result(meta_);
+        if(streaming_)
+            mysql_stmt_free_result(stmt_);
     }
 
     ///
@@ -426,6 +610,8 @@ public:
     ///
     virtual next_row has_next()
     {
+        if(streaming_)
+            return next_row_unknown;
         if(current_row_ >= mysql_stmt_num_rows(stmt_))
             return last_row_reached;
         else
@@ -438,28 +624,30 @@ public:
     virtual bool next()
     {
         current_row_ ++;
-        reset();
-        if(cols_ > 0) {
-            if(mysql_stmt_bind_result(stmt_,&bind_[0])) {
-                throw edba_myerror(mysql_stmt_error(stmt_));
-            }
-        }
         int r = mysql_stmt_fetch(stmt_);
         if(r==MYSQL_NO_DATA) {
             return false;
         }
-        if(r==MYSQL_DATA_TRUNCATED) {
-            for(int i=0;i<cols_;i++) {
-                if(bind_data_[i].error && !bind_data_[i].is_null && bind_data_[i].length >= sizeof(bind_data_[i].buf)) {
-                    bind_data_[i].vbuf.resize(bind_data_[i].length);
-                    MYSQL_BIND b=MYSQL_BIND();
-                    bind_[i].buffer = &bind_data_[i].vbuf.front();
-                    bind_[i].buffer_length = bind_data_[i].length;
-                    if(mysql_stmt_fetch_column(stmt_,&bind_[i],i,0)) {
-                        throw edba_myerror(mysql_stmt_error(stmt_));
-                    }
-                    bind_data_[i].ptr = &bind_data_[i].vbuf.front();
+        if(r==1) {
+            throw edba_myerror(mysql_stmt_error(stmt_));
+        }
+        fetched_ = true;
+        for(int i=0;i<cols_;i++) {
+            bind_data &d = bind_data_[i];
+            if(MYSQL_TYPE_STRING != d.type)
+                continue;
+
+            d.ptr = &d.buf.front();
+            if(r==MYSQL_DATA_TRUNCATED && d.error && !d.is_null && d.length > d.buf.size()) {
+                // Buffers are bound once, so long value is fetched into separate buffer
+                d.vbuf.resize(d.length);
+                MYSQL_BIND b = bind_[i];
+                b.buffer = &d.vbuf.front();
+                b.buffer_length = d.length;
+                if(mysql_stmt_fetch_column(stmt_,&b,i,0)) {
+                    throw edba_myerror(mysql_stmt_error(stmt_));
                 }
+                d.ptr = &d.vbuf.front();
             }
         }
         return true;
@@ -478,7 +666,31 @@ public:
         if(d.is_null)
             return false;
 
-        parse_number(string_ref(d.ptr,d.length), *v);
+        switch(d.type) {
+        case MYSQL_TYPE_LONGLONG:
+            if(d.is_unsigned && d.integer < 0) {
+                // Values above maximum of long long fit only unsigned long long and floating types
+                if(std::numeric_limits<T>::is_integer && sizeof(T) < sizeof(unsigned long long))
+                    throw bad_value_cast();
+                if(std::numeric_limits<T>::is_integer && std::numeric_limits<T>::is_signed)
+                    throw bad_value_cast();
+                *v = static_cast<T>(static_cast<unsigned long long>(d.integer));
+            }
+            else
+                assign_integer(d.integer, *v);
+            break;
+        case MYSQL_TYPE_DOUBLE:
+            assign_floating(d.floating, *v);
+            break;
+        case MYSQL_TYPE_FLOAT:
+            assign_floating(d.floating4, *v);
+            break;
+        case MYSQL_TYPE_STRING:
+            parse_number(string_ref(d.ptr,d.length), *v);
+            break;
+        default:
+            throw bad_value_cast();
+        }
 
         return true;
     }
@@ -488,7 +700,13 @@ public:
         bind_data &d = at(fetch_col_);
         if(d.is_null)
             return false;
-        v->assign(d.ptr,d.length);
+
+        if(MYSQL_TYPE_STRING == d.type)
+            v->assign(d.ptr,d.length);
+        else {
+            char buf[64];
+            v->assign(buf, format(d, buf, sizeof(buf)));
+        }
         return true;
     }
 
@@ -497,15 +715,37 @@ public:
         bind_data &d = at(fetch_col_);
         if(d.is_null)
             return false;
-        v->write(d.ptr,d.length);
+
+        if(MYSQL_TYPE_STRING == d.type)
+            v->write(d.ptr,d.length);
+        else {
+            char buf[64];
+            v->write(buf, format(d, buf, sizeof(buf)));
+        }
         return true;
     }
 
     bool operator()(std::tm* v)
     {
-        std::string tmp;
-        if(!this->operator()(&tmp))
+        bind_data &d = at(fetch_col_);
+        if(d.is_null)
             return false;
+
+        if(MYSQL_TYPE_DATETIME == d.type) {
+            std::tm t = std::tm();
+            t.tm_year = d.time.year - 1900;
+            t.tm_mon = d.time.month - 1;
+            t.tm_mday = d.time.day;
+            t.tm_hour = d.time.hour;
+            t.tm_min = d.time.minute;
+            t.tm_sec = d.time.second;
+            t.tm_isdst = -1;
+            *v = t;
+            return true;
+        }
+
+        std::string tmp;
+        this->operator()(&tmp);
         *v = parse_time(tmp);
         return true;
     }
@@ -526,7 +766,9 @@ public:
     }
     virtual boost::uint64_t rows()
     {
-        return boost::uint64_t(mysql_num_rows(meta_));
+        if(streaming_)
+            return boost::uint64_t(-1);
+        return boost::uint64_t(mysql_stmt_num_rows(stmt_));
     }
     virtual std::string column_to_name(int col)
     {
@@ -551,28 +793,119 @@ public:
     }
 
 private:
-    void reset()
+    ///
+    /// Choose buffer type for each column from result metadata and bind buffers once for the whole result
+    ///
+    void bind_columns()
     {
-        bind_.resize(0);
-        bind_data_.resize(0);
+        if(cols_ == 0)
+            return;
+
+        MYSQL_FIELD *flds=mysql_fetch_fields(meta_);
+        if(!flds) {
+            throw edba_myerror("Internal error empty fileds");
+        }
+
         bind_.resize(cols_,MYSQL_BIND());
-        bind_data_.resize(cols_,bind_data());
+        bind_data_.resize(cols_);
         for(int i=0;i<cols_;i++) {
-            bind_[i].buffer_type = MYSQL_TYPE_STRING;
-            bind_[i].buffer = bind_data_[i].buf;
-            bind_[i].buffer_length = sizeof(bind_data_[i].buf);
-            bind_[i].length = &bind_data_[i].length;
-            bind_[i].is_null = &bind_data_[i].is_null;
-            bind_[i].error = &bind_data_[i].error;
-            bind_data_[i].ptr = bind_data_[i].buf;
+            bind_data &d = bind_data_[i];
+            MYSQL_BIND &b = bind_[i];
+
+            switch(flds[i].type) {
+            case MYSQL_TYPE_TINY:
+            case MYSQL_TYPE_SHORT:
+            case MYSQL_TYPE_LONG:
+            case MYSQL_TYPE_INT24:
+            case MYSQL_TYPE_LONGLONG:
+            case MYSQL_TYPE_YEAR:
+                d.type = MYSQL_TYPE_LONGLONG;
+                d.is_unsigned = (flds[i].flags & UNSIGNED_FLAG) ? 1 : 0;
+                b.buffer = &d.integer;
+                b.buffer_length = sizeof(d.integer);
+                break;
+            case MYSQL_TYPE_DOUBLE:
+                d.type = MYSQL_TYPE_DOUBLE;
+                b.buffer = &d.floating;
+                b.buffer_length = sizeof(d.floating);
+                break;
+            case MYSQL_TYPE_FLOAT:
+                d.type = MYSQL_TYPE_FLOAT;
+                b.buffer = &d.floating4;
+                b.buffer_length = sizeof(d.floating4);
+                break;
+            case MYSQL_TYPE_DATE:
+            case MYSQL_TYPE_DATETIME:
+            case MYSQL_TYPE_TIMESTAMP:
+                d.type = MYSQL_TYPE_DATETIME;
+                d.decimals = MYSQL_TYPE_DATE == flds[i].type ? 0 : flds[i].decimals;
+                d.time.time_type = MYSQL_TYPE_DATE == flds[i].type ? MYSQL_TIMESTAMP_DATE : MYSQL_TIMESTAMP_DATETIME;
+                b.buffer = &d.time;
+                b.buffer_length = sizeof(d.time);
+                break;
+            default:
+                // max_length is known only for stored results
+                d.type = MYSQL_TYPE_STRING;
+                d.buf.resize(flds[i].max_length > 0 ? flds[i].max_length + 1 : 128);
+                b.buffer = &d.buf.front();
+                b.buffer_length = d.buf.size();
+                d.ptr = &d.buf.front();
+            }
+
+            b.buffer_type = d.type;
+            b.is_unsigned = d.is_unsigned;
+            b.length = &d.length;
+            b.is_null = &d.is_null;
+            b.error = &d.error;
+        }
+
+        if(mysql_stmt_bind_result(stmt_,&bind_[0])) {
+            throw edba_myerror(mysql_stmt_error(stmt_));
+        }
+    }
+
+    ///
+    /// Format number or time column into \a buf as MySQL does and return length of the text
+    ///
+    static std::size_t format(bind_data const &d, char *buf, std::size_t size)
+    {
+        int len = 0;
+        switch(d.type) {
+        case MYSQL_TYPE_LONGLONG:
+            len = d.is_unsigned
+                ? EDBA_SNPRINTF(buf, size, "%llu", static_cast<unsigned long long>(d.integer))
+                : EDBA_SNPRINTF(buf, size, "%lld", d.integer);
+            break;
+        case MYSQL_TYPE_DOUBLE:
+            len = EDBA_SNPRINTF(buf, size, "%.*g", std::numeric_limits<double>::digits10 + 1, d.floating);
+            break;
+        case MYSQL_TYPE_FLOAT:
+            len = EDBA_SNPRINTF(buf, size, "%.*g", std::numeric_limits<float>::digits10 + 1, static_cast<double>(d.floating4));
+            break;
+        default:
+            if(MYSQL_TIMESTAMP_DATE == d.time.time_type) {
+                len = EDBA_SNPRINTF(buf, size, "%04u-%02u-%02u", d.time.year, d.time.month, d.time.day);
+                break;
+            }
+
+            len = EDBA_SNPRINTF(buf, size, "%04u-%02u-%02u %02u:%02u:%02u", 
+                d.time.year, d.time.month, d.time.day, d.time.hour, d.time.minute, d.time.second);
+
+            if(d.decimals > 0 && d.decimals <= 6) {
+                unsigned long fraction = d.time.second_part;
+                for(unsigned i = d.decimals; i < 6; ++i)
+                    fraction /= 10;
+                len += EDBA_SNPRINTF(buf + len, size - len, ".%0*lu", int(d.decimals), fraction);
+            }
         }
+        return std::size_t(len);
     }
 
     bind_data &at(int col)
     {
         if(col < 0 || col >= cols_)
             throw invalid_column(col);
-        if(bind_data_.empty())
+        if(!fetched_)
             throw edba_myerror("Attempt to access data without fetching it first");
         return bind_data_.at(col);
     }
@@ -583,65 +916,116 @@ private:
     MYSQL_RES *meta_;
     std::vector<MYSQL_BIND> bind_;
     std::vector<bind_data> bind_data_;
+    bool fetched_;
+    bool streaming_;
     int fetch_col_;
 };
 
 class statement : public backend::statement, public boost::static_visitor<>
 {
+    ///
+    /// Parameter keeps value in its native MySQL type. Numbers and time are stored inside of param,
+    /// so binding new value of the same type doesn`t change MYSQL_BIND layout.
+    ///
     struct param
     {
+        enum_field_types type;
         my_bool is_null;
-        bool is_blob;
+        my_bool is_unsigned;
         unsigned long length;
         std::string value;
         void *buffer;
+        long long integer;
+        double floating;
+        MYSQL_TIME time;
 
         param() :
-            is_null(1)
-          , is_blob(false)
+            type(MYSQL_TYPE_NULL)
+          , is_null(1)
+          , is_unsigned(0)
           , length(0)
           , buffer(0)
+          , integer(0)
+          , floating(0)
         {
+            memset(&time,0,sizeof(time));
         }
         void set(char const *b,char const *e,bool blob=false)
         {
+            type = blob ? MYSQL_TYPE_BLOB : MYSQL_TYPE_STRING;
             length = e - b;
             buffer = const_cast<char *>(b);
-            is_blob = blob;
+            is_unsigned = 0;
             is_null = 0;
         }
-        void set_str(std::string const &s)
+        void set_str(std::string const &s,bool blob=false)
         {
             value = s;
-            buffer = const_cast<char *>(value.c_str());
-            length = value.size();
+            set(value.c_str(), value.c_str() + value.size(), blob);
+        }
+        void set_integer(long long v,bool is_unsigned_value=false)
+        {
+            type = MYSQL_TYPE_LONGLONG;
+            integer = v;
+            buffer = &integer;
+            length = sizeof(integer);
+            is_unsigned = is_unsigned_value;
+            is_null = 0;
+        }
+        void set_floating(double v)
+        {
+            type = MYSQL_TYPE_DOUBLE;
+            floating = v;
+            buffer = &floating;
+            length = sizeof(floating);
+            is_unsigned = 0;
             is_null = 0;
         }
         void set(std::tm const &t)
         {
-            set_str(format_time(t));
+            type = MYSQL_TYPE_DATETIME;
+            memset(&time,0,sizeof(time));
+            time.year = t.tm_year + 1900;
+            time.month = t.tm_mon + 1;
+            time.day = t.tm_mday;
+            time.hour = t.tm_hour;
+            time.minute = t.tm_min;
+            time.second = t.tm_sec;
+            time.time_type = MYSQL_TIMESTAMP_DATETIME;
+            buffer = &time;
+            length = sizeof(time);
+            is_unsigned = 0;
+            is_null = 0;
+        }
+        void set_null()
+        {
+            // Keep type of the previous value to avoid rebinding
+            is_null = 1;
+        }
+        bool same_layout(MYSQL_BIND const &b) const
+        {
+            return b.buffer_type == type && b.buffer == buffer && b.is_unsigned == is_unsigned;
         }
         void bind_it(MYSQL_BIND *b)
         {
+            b->buffer_type = type;
+            b->buffer = buffer;
+            b->buffer_length = length;
+            b->length = &length;
             b->is_null = &is_null;
-            if(!is_null) {
-                b->buffer_type = is_blob ? MYSQL_TYPE_BLOB : MYSQL_TYPE_STRING;
-                b->buffer = buffer;
-                b->buffer_length = length;
-                b->length = &length;
-            }
-            else {
-                b->buffer_type = MYSQL_TYPE_NULL;
-            }
+            b->is_unsigned = is_unsigned;
         }
     };
 
 public:
-    statement(const string_ref& q, MYSQL *conn, session_stat* stat) 
+    statement(const string_ref& q, MYSQL *conn, session_stat* stat, bool stream_results = false) 
       : backend::statement(stat)
       , bind_by_name_helper_(q, detail::question_marker())
+      , conn_(conn)
       , stmt_(0)
       , params_count_(0)
+      , bound_(false)
+      , stream_results_(stream_results)
     {
         fmt_.imbue(std::locale::classic());
 
@@ -657,7 +1041,8 @@ public:
                 throw edba_myerror(mysql_stmt_error(stmt_));
             }
             params_count_ = mysql_stmt_param_count(stmt_);
-            reset_data();
+            params_.resize(params_count_);
+            bind_.resize(params_count_,MYSQL_BIND());
         }
         catch(...) {
             if(stmt_)
@@ -689,13 +1074,47 @@ public:
         v.apply_visitor(*this);
     }
 
+    virtual void bind_null_impl(int col)
+    {
+        at(col).set_null();
+    }
+
+    virtual void bind_int64_impl(int col, long long v)
+    {
+        at(col).set_integer(v);
+    }
+
+    virtual void bind_double_impl(int col, double v)
+    {
+        at(col).set_floating(v);
+    }
+
+    virtual void bind_text_impl(int col, const string_ref& v)
+    {
+        at(col).set(v.begin(), v.end());
+    }
+
     template<typename T>
-    void operator()(T v, typename boost::enable_if< boost::is_arithmetic<T> >::type* = 0)
+    void operator()(T v, typename boost::enable_if< boost::is_integral<T> >::type* = 0)
+    {
+        at(bind_col_).set_integer(static_cast<long long>(v), !std::numeric_limits<T>::is_signed);
+    }
+
+    void operator()(float v)
+    {
+        at(bind_col_).set_floating(v);
+    }
+
+    void operator()(double v)
+    {
+        at(bind_col_).set_floating(v);
+    }
+
+    void operator()(long double v)
     {
+        // There is no native type with long double precision
         fmt_.str(std::string());
-        if(!std::numeric_limits<T>::is_integer)
-            fmt_ << std::setprecision(std::numeric_limits<T>::digits10+1);
-        fmt_ << v;
+        fmt_ << std::setprecision(std::numeric_limits<long double>::digits10+1) << v;
         at(bind_col_).set_str(fmt_.str());
     }
 
@@ -713,13 +1132,12 @@ public:
     {
         std::ostringstream ss;
         ss << v->rdbuf();
-        at(bind_col_).set_str(ss.str());
-        at(bind_col_).is_blob = true;
+        at(bind_col_).set_str(ss.str(), true);
     }
 
     void operator()(null_type)
     {
-        at(bind_col_)=param();
+        at(bind_col_).set_null();
     }
 
     // ----------- backend::statement -----------
@@ -756,7 +1174,7 @@ public:
         if(mysql_stmt_execute(stmt_)) {
             throw edba_myerror(mysql_stmt_error(stmt_));
         }
-        return backend::result_ptr(new result(stmt_));
+        return backend::result_ptr(new result(stmt_, stream_results_ || streamed_result == result_mode_));
     }
     ///
     /// Execute a statement, MAY throw edba_error if the statement returns results.
@@ -777,13 +1195,27 @@ public:
         }
     }
 
+    ///
+    /// Prepared statements can`t insert multiple rows with single execution, so batches of positional
+    /// parameters are executed by unprepared statement that rewrites query into multi row insert.
+    ///
+    virtual unsigned long long exec_many_impl(const backend::bind_rows& rows)
+    {
+        if (rows.rows() < 2 || !rows.dense(params_count_))
+            return backend::statement::exec_many_impl(rows);
+
+        if (!batch_)
+            batch_ = new unprep::statement(patched_query(), conn_, stat_.parent_stat());
+
+        return batch_->exec_many_impl(rows);
+    }
+
 private:
     void reset_data()
     {
-        params_.resize(0);
-        params_.resize(params_count_);
-        bind_.resize(0);
-        bind_.resize(params_count_,MYSQL_BIND());
+        // Reset values in place, so buffers of numbers keep their addresses and bind_ stays valid
+        BOOST_FOREACH(param& p, params_)
+            p.set_null();
     }
 
     param &at(int col)
@@ -793,14 +1225,29 @@ private:
         return params_[col-1];
     }
 
+    ///
+    /// Call mysql_stmt_bind_param only if types or buffers of parameters have changed since the last execution,
+    /// values and lengths are read by pointers to params_
+    ///
     void bind_all()
     {
-        if(!params_.empty()) {
-            for(unsigned i=0;i<params_.size();i++)
+        if(params_.empty())
+            return;
+
+        bool changed = !bound_;
+        for(unsigned i=0;i<params_.size();i++) {
+            if(!params_[i].same_layout(bind_[i])) {
                 params_[i].bind_it(&bind_[i]);
+                changed = true;
+            }
+        }
+
+        if(changed) {
+            bound_ = false;
             if(mysql_stmt_bind_param(stmt_,&bind_.front())) {
                 throw edba_myerror(mysql_stmt_error(stmt_));
             }
+            bound_ = true;
         }
     }
 
@@ -809,20 +1256,459 @@ private:
     std::vector<MYSQL_BIND> bind_;
 
     detail::bind_by_name_helper bind_by_name_helper_;
+    MYSQL *conn_;
     MYSQL_STMT *stmt_;
     int params_count_;
+    bool bound_;    // bind_ layout was passed to mysql_stmt_bind_param
+    bool stream_results_;   // @mysql_stream=on
+    boost::intrusive_ptr<unprep::statement> batch_;
     int bind_col_;
 };
 
 } // namespace prep
 
+namespace load {
+
+/// Maximal size of rows buffered by bulk writer before they are sent by separate LOAD DATA
+const std::size_t chunk_size = 16 * 1024 * 1024;
+
+typedef enum
+{
+    backslash_escape,   // tab separated fields with backslash escapes, NULL is \N
+    csv_escape          // comma separated fields enclosed in quotes, quotes are doubled, NULL is NULL
+} escape_type;
+
+///
+/// Data source for LOAD DATA LOCAL INFILE, client library reads it via local infile handler
+///
+struct source
+{
+    virtual ~source() {}
+
+    /// Copy up to \a len bytes into \a buf, return 0 at the end of data
+    virtual std::size_t read(char *buf, std::size_t len) = 0;
+
+    std::string error_;
+};
+
+struct buffer_source : source
+{
+    buffer_source(const std::string& data) : data_(data), pos_(0) {}
+
+    virtual std::size_t read(char *buf, std::size_t len)
+    {
+        std::size_t n = (std::min)(len, data_.size() - pos_);
+        memcpy(buf, data_.data() + pos_, n);
+        pos_ += n;
+        return n;
+    }
+
+    const std::string& data_;
+    std::size_t pos_;
+};
+
+struct stream_source : source
+{
+    stream_source(std::istream& in) : in_(in) {}
+
+    virtual std::size_t read(char *buf, std::size_t len)
+    {
+        in_.read(buf, len);
+        if(in_.bad())
+            throw edba_myerror("failed reading bulk writer input stream");
+        return std::size_t(in_.gcount());
+    }
+
+    std::istream& in_;
+};
+
+int infile_init(void **ptr, const char *, void *userdata)
+{
+    *ptr = userdata;
+    return 0;
+}
+
+int infile_read(void *ptr, char *buf, unsigned int len)
+{
+    source *s = static_cast<source*>(ptr);
+    try {
+        return int(s->read(buf, len));
+    }
+    catch(std::exception const &e) {
+        s->error_ = e.what();
+    }
+    catch(...) {
+        s->error_ = "unknown error in bulk writer data source";
+    }
+    return -1;
+}
+
+void infile_end(void *)
+{
+}
+
+int infile_error(void *ptr, char *msg, unsigned int len)
+{
+    source *s = static_cast<source*>(ptr);
+    EDBA_SNPRINTF(msg, len, "%s", s->error_.c_str());
+    return 2000; // CR_UNKNOWN_ERROR
+}
+
+///
+/// Row of bulk writer, values are bound as parameters of statement and encoded as lines of
+/// LOAD DATA input. Encoded rows are buffered and sent by chunks, each chunk is loaded by 
+/// single LOAD DATA LOCAL INFILE statement with local infile handler reading from memory.
+///
+class statement : public backend::statement, public boost::static_visitor<>
+{
+public:
+    statement(MYSQL *conn, const string_ref& table, const string_ref& columns, escape_type escape, session_stat* stat)
+      : backend::statement(stat)
+      , conn_(conn)
+      , escape_(escape)
+      , finished_(false)
+      , buffered_rows_(0)
+      , loaded_(0)
+      , skipped_(0)
+      , bind_col_(0)
+    {
+        std::string cols = columns.empty() ? std::string("*") : std::string(columns.begin(), columns.end());
+        std::string tbl(table.begin(), table.end());
+
+        // Get names of loaded columns
+        std::string probe = "SELECT " + cols + " FROM " + tbl + " LIMIT 0";
+        if(mysql_real_query(conn_, probe.c_str(), probe.size()))
+            throw edba_myerror(mysql_error(conn_));
+
+        MYSQL_RES *r = mysql_store_result(conn_);
+        if(!r)
+            throw edba_myerror(mysql_error(conn_));
+
+        BOOST_SCOPE_EXIT((r))
+        {
+            mysql_free_result(r);
+        } BOOST_SCOPE_EXIT_END
+
+        MYSQL_FIELD *flds = mysql_fetch_fields(r);
+        for(unsigned i = 0; i < mysql_num_fields(r); ++i)
+            names_.push_back(flds[i].name);
+
+        query_ = "LOAD DATA LOCAL INFILE 'edba_bulk_writer' INTO TABLE " + tbl + " CHARACTER SET utf8 ";
+        if(backslash_escape == escape_)
+            query_ += "FIELDS TERMINATED BY '\\t' ESCAPED BY '\\\\' LINES TERMINATED BY '\\n'";
+        else
+            query_ += "FIELDS TERMINATED BY ',' OPTIONALLY ENCLOSED BY '\"' ESCAPED BY '' LINES TERMINATED BY '\\n'";
+        if(!columns.empty())
+            query_ += " (" + cols + ")";
+
+        reset_bindings_impl();
+    }
+
+    virtual const std::string& patched_query() const
+    {
+        return query_;
+    }
+
+    virtual void reset_bindings_impl()
+    {
+        values_.resize(names_.size());
+        BOOST_FOREACH(std::string& s, values_)
+            s.clear();
+
+        nulls_.assign(names_.size(), true);
+    }
+
+    virtual void bind_impl(int col, bind_types_variant const& v)
+    {
+        if(col < 1 || col > int(names_.size()))
+            throw invalid_column(col - 1);
+
+        bind_col_ = col;
+        nulls_[col - 1] = false;
+        values_[col - 1].clear();
+
+        v.apply_visitor(*this);
+    }
+
+    virtual void bind_impl(const string_ref& name, bind_types_variant const& v)
+    {
+        for(std::size_t i = 0; i < names_.size(); ++i)
+        {
+            if(boost::algorithm::iequals(names_[i], name))
+                return bind_impl(int(i + 1), v);
+        }
+
+        throw invalid_column(std::string(name.begin(), name.end()));
+    }
+
+    virtual backend::result_ptr query_impl()
+    {
+        throw edba_myerror("bulk writer row can`t be used as query");
+    }
+
+    virtual void exec_impl()
+    {
+        throw edba_myerror("bulk writer row can`t be executed, use bulk_writer::end_row");
+    }
+
+    virtual long long sequence_last(std::string const &)
+    {
+        throw not_supported_by_backend("edba::bulk_writer doesn`t support last_insert_id");
+    }
+
+    virtual unsigned long long affected()
+    {
+        return loaded_;
+    }
+
+    template<typename T>
+    void operator()(T v, typename boost::enable_if< boost::is_integral<T> >::type* = 0)
+    {
+        char buf[32];
+        int len = std::numeric_limits<T>::is_signed
+            ? EDBA_SNPRINTF(buf, sizeof(buf), "%lld", static_cast<long long>(v))
+            : EDBA_SNPRINTF(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(v));
+        values_[bind_col_ - 1].assign(buf, len);
+    }
+
+    template<typename T>
+    void operator()(T v, typename boost::enable_if< boost::is_floating_point<T> >::type* = 0)
+    {
+        char buf[64];
+        int len = EDBA_SNPRINTF(buf, sizeof(buf), "%.*Lg", std::numeric_limits<T>::digits10 + 1, static_cast<long double>(v));
+        values_[bind_col_ - 1].assign(buf, len);
+    }
+
+    void operator()(const string_ref& v)
+    {
+        values_[bind_col_ - 1].assign(v.begin(), v.end());
+    }
+
+    void operator()(const std::tm& v)
+    {
+        values_[bind_col_ - 1] = format_time(v);
+    }
+
+    void operator()(std::istream* in)
+    {
+        std::ostringstream ss;
+        ss << in->rdbuf();
+        values_[bind_col_ - 1] = ss.str();
+    }
+
+    void operator()(null_type)
+    {
+        nulls_[bind_col_ - 1] = true;
+    }
+
+    /// Encode bound values as the next line of LOAD DATA input
+    void end_row()
+    {
+        check();
+
+        for(std::size_t i = 0; i < names_.size(); ++i)
+        {
+            if(i > 0)
+                buffer_ += backslash_escape == escape_ ? '\t' : ',';
+
+            if(nulls_[i])
+                buffer_ += backslash_escape == escape_ ? "\\N" : "NULL";
+            else
+                append_escaped(values_[i]);
+        }
+        buffer_ += '\n';
+        ++buffered_rows_;
+
+        if(buffer_.size() >= chunk_size)
+            flush();
+    }
+
+    /// Load data that is already encoded in LOAD DATA format
+    void write_raw(std::istream& in)
+    {
+        check();
+        flush();
+
+        stream_source src(in);
+        load(src, 0);
+    }
+
+    unsigned long long finish()
+    {
+        check();
+        flush();
+        finished_ = true;
+        return loaded_;
+    }
+
+    unsigned long long skipped() const
+    {
+        return skipped_;
+    }
+
+    /// Drop buffered rows, never throws
+    void cancel()
+    {
+        finished_ = true;
+        buffer_.clear();
+        buffered_rows_ = 0;
+    }
+
+private:
+    void check()
+    {
+        if(finished_)
+            throw edba_myerror("bulk writer is already finished");
+    }
+
+    /// Append value escaped according to selected LOAD DATA format
+    void append_escaped(const std::string& v)
+    {
+        if(csv_escape == escape_)
+        {
+            buffer_ += '"';
+            BOOST_FOREACH(char c, v)
+            {
+                if(c == '"')
+                    buffer_ += '"';
+                buffer_ += c;
+            }
+            buffer_ += '"';
+            return;
+        }
+
+        BOOST_FOREACH(char c, v)
+        {
+            switch(c)
+            {
+            case '\\': buffer_ += "\\\\"; break;
+            case '\t': buffer_ += "\\t"; break;
+            case '\n': buffer_ += "\\n"; break;
+            case '\r': buffer_ += "\\r"; break;
+            case '\0': buffer_ += "\\0"; break;
+            default: buffer_ += c;
+            }
+        }
+    }
+
+    void flush()
+    {
+        if(buffer_.empty())
+            return;
+
+        buffer_source src(buffer_);
+        load(src, buffered_rows_);
+        buffer_.clear();
+        buffered_rows_ = 0;
+    }
+
+    /// Execute LOAD DATA reading input from \a src, add loaded and skipped rows to counters
+    void load(source& src, std::size_t rows)
+    {
+        unsigned long long affected = 0;
+        statement_stat::measure_batch m(&stat_, &query_, rows, &affected);
+
+        mysql_set_local_infile_handler(conn_, &infile_init, &infile_read, &infile_end, &infile_error, &src);
+
+        BOOST_SCOPE_EXIT((conn_))
+        {
+            mysql_set_local_infile_default(conn_);
+        } BOOST_SCOPE_EXIT_END
+
+        if(mysql_real_query(conn_, query_.c_str(), query_.size()))
+            throw edba_myerror(src.error_.empty() ? std::string(mysql_error(conn_)) : src.error_);
+
+        affected = mysql_affected_rows(conn_);
+        loaded_ += affected;
+
+        // Info string looks like "Records: 3  Deleted: 0  Skipped: 1  Warnings: 1"
+        if(const char *info = mysql_info(conn_))
+        {
+            if(const char *s = strstr(info, "Skipped: "))
+                skipped_ += atoll(s + 9);
+        }
+    }
+
+    MYSQL *conn_;
+    escape_type escape_;
+    bool finished_;
+    std::string query_;
+    std::vector<std::string> names_;
+    std::vector<std::string> values_;
+    std::vector<bool> nulls_;
+    std::string buffer_;
+    std::size_t buffered_rows_;
+    unsigned long long loaded_;
+    unsigned long long skipped_;
+    int bind_col_;
+};
+
+class writer : public backend::bulk_writer_iface
+{
+public:
+    writer(statement* st) : row_(st)
+    {
+    }
+
+    virtual backend::statement_ptr row()
+    {
+        return row_;
+    }
+
+    virtual void end_row()
+    {
+        row_->end_row();
+    }
+
+    virtual void write_raw(std::istream& in)
+    {
+        row_->write_raw(in);
+    }
+
+    virtual unsigned long long finish()
+    {
+        return row_->finish();
+    }
+
+    virtual unsigned long long skipped()
+    {
+        return row_->skipped();
+    }
+
+    virtual void cancel()
+    {
+        row_->cancel();
+    }
+
+private:
+    boost::intrusive_ptr<statement> row_;
+};
+
+} // namespace load
+
 class connection : public backend::connection
 {
 public:
     connection(conn_info const &ci, session_monitor* sm) :
         backend::connection(ci, sm)
       , conn_(0)
+      , stream_results_(false)
+      , load_escape_(load::backslash_escape)
     {
+        string_ref stream = ci.get("@mysql_stream", "off");
+
+        if(boost::algorithm::iequals(stream, "on"))
+            stream_results_ = true;
+        else if(!boost::algorithm::iequals(stream, "off"))
+            throw edba_myerror("@mysql_stream property should be either on or off");
+
+        string_ref load_escape = ci.get("@mysql_load_escape", "backslash");
+
+        if(boost::algorithm::iequals(load_escape, "csv"))
+            load_escape_ = load::csv_escape;
+        else if(!boost::algorithm::iequals(load_escape, "backslash"))
+            throw edba_myerror("@mysql_load_escape property should be either backslash or csv");
+
         conn_ = mysql_init(0);
         if(!conn_) {
               throw edba_error("edba::mysql failed to create connection");
@@ -866,7 +1752,7 @@ public:
         }
         if(ci.has("opt_local_infile")) {
             if(unsigned local_infile = ci.get("opt_local_infile", 0)) {
-                mysql_set_option(MYSQL_OPT_CONNECT_TIMEOUT, &local_infile);
+                mysql_set_option(MYSQL_OPT_LOCAL_INFILE, &local_infile);
             }
         }
         if(ci.has("opt_named_pipe")) {
@@ -1034,12 +1920,20 @@ public:
     
     virtual backend::statement_ptr prepare_statement_impl(const string_ref& q)
     {
-        return backend::statement_ptr(new prep::statement(q, conn_, &stat_));
+        return backend::statement_ptr(new prep::statement(q, conn_, &stat_, stream_results_));
     }
 
     virtual backend::statement_ptr create_statement_impl(const string_ref& q)
     {
-        return backend::statement_ptr(new unprep::statement(q, conn_, &stat_));
+        return backend::statement_ptr(new unprep::statement(q, conn_, &stat_, stream_results_));
+    }
+
+    virtual backend::bulk_writer_ptr create_bulk_writer_impl(const string_ref& table, const string_ref& columns, bulk_format format)
+    {
+        if(bulk_binary_format == format)
+            throw not_supported_by_backend("edba::mysql bulk writer supports only bulk_text_format");
+
+        return backend::bulk_writer_ptr(new load::writer(new load::statement(conn_, table, columns, load_escape_, &stat_)));
     }
     
     virtual std::string escape(const string_ref& str)
@@ -1082,6 +1976,8 @@ private:
 
     MYSQL *conn_;
     std::string description_;
+    bool stream_results_;   // use unbuffered results for all queries
+    load::escape_type load_escape_;
 };
 
 }}}} // edba, backend, mysql, anonymous
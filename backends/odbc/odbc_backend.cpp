@@ -2,6 +2,7 @@
 #include <edba/detail/handle.hpp>
 #include <edba/detail/bind_by_name_helper.hpp>
 #include <edba/backend/implementation_base.hpp>
+#include <edba/backend/param_kind.hpp>
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/find_iterator.hpp>
@@ -112,6 +113,7 @@ struct common_data
     string last_insert_id_;
     SQLUSMALLINT commit_behavior_;
     SQLUSMALLINT rollback_behavior_;
+    SQLULEN block_size_;    // @odbc_block_size, number of rows fetched by single SQLFetch
 };
 
 // backend name
@@ -169,8 +171,17 @@ struct error_checker
 
         boost::format fmt("edba::backend::odbc %1% failed with error %2% (%3%)");
 
+        SQLINTEGER err = 0;
+        string msg = diagnostics(err);
+
+        throw edba_error((fmt % api_ % msg % err).str());
+        return error;
+    }
+
+    // Collect all diagnostic records of the handle into single message
+    string diagnostics(SQLINTEGER& err) const
+    {
         int rec = 1;
-        SQLINTEGER err;
         SQLSMALLINT len;
         string msg;
 
@@ -219,12 +230,13 @@ struct error_checker
             }
         }
 
-        throw edba_error((fmt % api_ % msg % err).str());
-        return error;
+        return msg;
     }
 };
 
-class result : public backend::result, public boost::static_visitor<bool>
+// Columns of query result described by SQLDescribeCol together with buffers of block cursor.
+// Prepared statement keeps them and reuses by the following executions, so columns are described only once.
+struct result_columns
 {
     typedef multi_index_container<
         column_info
@@ -234,19 +246,26 @@ class result : public backend::result, public boost::static_visitor<bool>
           >
       > columns_set;
 
-public:
-    result(SQLHSTMT stmt, bool wide)
-        : stmt_(stmt)
-        , wide_(wide)
-        , throw_on_error_(wide, stmt, SQL_HANDLE_STMT)
+    // Column-wise array of block cursor, filled by SQLFetch for all rows of the block
+    struct column_block
     {
-        // Read number of columns
-        SQLSMALLINT columns_count;
-        throw_on_error_("SQLNumResultCols") = SQLNumResultCols(stmt_, &columns_count);
+        SQLLEN size_;               // size of single value in bytes
+        vector<char> values_;
+        vector<SQLLEN> indicators_;
+    };
+
+    result_columns(SQLHSTMT stmt, bool wide, SQLSMALLINT columns_count, SQLULEN block_size)
+        : block_size_(block_size)
+        , valid_(true)
+    {
+        error_checker throw_on_error(wide, stmt, SQL_HANDLE_STMT);
+
         columns_.reserve(columns_count);
+        ctypes_.reserve(columns_count);
 
-        // This variable will hold maximum column size over all parameters
-        SQLULEN max_column_size = 0;
+        // Column sizes as reported by SQLDescribeCol
+        vector<SQLULEN> column_sizes;
+        column_sizes.reserve(columns_count);
 
         // For each column get name, and push back into columns_
         for(SQLSMALLINT col = 0; col < columns_count; col++)
@@ -255,59 +274,153 @@ public:
             SQLSMALLINT name_length = 0;
             SQLULEN column_size = 0;
 
-            if(wide_)
+            if(wide)
             {
                 SQLWCHAR name[257] = {0};
-                throw_on_error_("SQLDescribeColW") = SQLDescribeColW(stmt_, col + 1, name, 256, &name_length, &ci.type_, &column_size, 0, 0);
+                throw_on_error("SQLDescribeColW") = SQLDescribeColW(stmt, col + 1, name, 256, &name_length, &ci.type_, &column_size, 0, 0);
                 ci.name_ = utf_to_utf<char>(name);
             }
             else
             {
                 SQLCHAR name[257] = {0};
-                throw_on_error_("SQLDescribeColA") = SQLDescribeColA(stmt_, col + 1, name, 256, &name_length, &ci.type_, &column_size, 0, 0);
+                throw_on_error("SQLDescribeColA") = SQLDescribeColA(stmt, col + 1, name, 256, &name_length, &ci.type_, &column_size, 0, 0);
                 ci.name_ = (char*)name;
             }
 
-            bool is_wide_char_type = 
-                SQL_WCHAR == ci.type_ ||
-                SQL_WVARCHAR == ci.type_ ||
-                SQL_WLONGVARCHAR == ci.type_;
+            column_sizes.push_back(column_size);
+            ctypes_.push_back(fetch_ctype(ci.type_));
+            columns_.push_back(ci);
+        }
 
-            bool is_any_char_type = 
-                is_wide_char_type || 
-                SQL_CHAR == ci.type_ ||
-                SQL_VARCHAR == ci.type_ ||
-                SQL_LONGVARCHAR == ci.type_;
+        if (block_size > 1)
+            allocate_blocks(column_sizes);
+    }
 
-            bool is_var_size_type = 
-                is_any_char_type || 
-                SQL_VARBINARY == ci.type_ ||
-                SQL_LONGVARBINARY == ci.type_;
+    columns_set columns_;
+    vector<SQLSMALLINT> ctypes_;    // C types columns are read as
+    vector<column_block> blocks_;   // Buffers of block cursor, empty if rows are fetched one by one
+    SQLULEN block_size_;            // Number of rows in block
+    bool valid_;                    // False after failed fetch, then columns are described again by next execution
 
-            // For types like varchar(max) and varbinary(max) column_size == 0
-            // Explicitly assign column size
-            if (is_var_size_type && 0 == column_size)
-                column_size = MAX_READ_BUFFER_SIZE;
-            else if (is_wide_char_type)
-                column_size *= 2;
+private:
+    // C type values of SQL type are read as. Decimals and types unknown to ODBC are read as text.
+    static SQLSMALLINT fetch_ctype(SQLSMALLINT type)
+    {
+        switch(type)
+        {
+        case SQL_TYPE_DATE:
+        case SQL_TYPE_TIME:
+        case SQL_TYPE_TIMESTAMP:
+            return SQL_C_TYPE_TIMESTAMP;
+        case SQL_BIT:
+        case SQL_TINYINT:
+        case SQL_SMALLINT:
+        case SQL_INTEGER:
+        case SQL_BIGINT:
+            return SQL_C_SBIGINT;
+        case SQL_REAL:
+        case SQL_FLOAT:
+        case SQL_DOUBLE:
+            return SQL_C_DOUBLE;
+        case SQL_WCHAR:
+        case SQL_WVARCHAR:
+        case SQL_WLONGVARCHAR:
+            return SQL_C_WCHAR;
+        case SQL_BINARY:
+        case SQL_VARBINARY:
+        case SQL_LONGVARBINARY:
+            return SQL_C_BINARY;
+        default:
+            return SQL_C_CHAR;
+        }
+    }
 
-            if (column_size > max_column_size)
-                max_column_size = column_size;
+    // Allocate column-wise arrays of block_size_ rows for all columns. Rows are fetched one by one if any column
+    // has long or unknown type, because most drivers don`t support SQLGetData for block cursors.
+    void allocate_blocks(const vector<SQLULEN>& column_sizes)
+    {
+        vector<column_block> blocks(columns_.size());
 
-            columns_.push_back(ci);
+        for(size_t col = 0; col < blocks.size(); ++col)
+        {
+            column_block& b = blocks[col];
+            SQLULEN size = column_sizes[col];
+            SQLSMALLINT ctype = ctypes_[col];
+
+            if (SQL_C_SBIGINT == ctype || SQL_C_DOUBLE == ctype)
+                b.size_ = sizeof(long long);
+            else if (SQL_C_TYPE_TIMESTAMP == ctype)
+                b.size_ = sizeof(TIMESTAMP_STRUCT);
+            else if (0 == size || size > MAX_READ_BUFFER_SIZE)
+                return;
+            else
+            {
+                switch(columns_[col].type_)
+                {
+                case SQL_DECIMAL:
+                case SQL_NUMERIC:
+                    // digits, sign, decimal point and null character
+                    b.size_ = size + 3;
+                    break;
+                case SQL_CHAR:
+                case SQL_VARCHAR:
+                    // up to 4 bytes per character in UTF-8 and null character
+                    b.size_ = size * 4 + 1;
+                    break;
+                case SQL_WCHAR:
+                case SQL_WVARCHAR:
+                    b.size_ = (size + 1) * sizeof(SQLWCHAR);
+                    break;
+                case SQL_BINARY:
+                case SQL_VARBINARY:
+                    b.size_ = size;
+                    break;
+                default:
+                    return;
+                }
+            }
+
+            // Keep values of all rows aligned for long long and double
+            b.size_ += (sizeof(double) - b.size_ % sizeof(double)) % sizeof(double);
+            b.values_.resize(b.size_ * block_size_);
+            b.indicators_.resize(block_size_);
         }
 
-        // Reserve one byte for null character, in case of string
-        // Figure out do we actually need this
-        max_column_size += 1;
+        blocks_.swap(blocks);
+    }
+};
+
+typedef boost::shared_ptr<result_columns> result_columns_ptr;
+
+class result : public backend::result, public boost::static_visitor<bool>
+{
+    typedef result_columns::columns_set columns_set;
+    typedef result_columns::column_block column_block;
 
-        // Align size to 2
-        // If some column will be extracted as wide char string, we will 
-        // provide size of bytes divisible by 2
-        max_column_size += (max_column_size % 2);
+    // Column of current row read by SQLGetData into arena_
+    struct cell
+    {
+        SQLLEN indicator_;          // SQL_NULL_DATA or length of value in bytes
+        size_t offset_;             // position of value in arena_
+    };
+
+public:
+    /// Create result over columns \a desc described by statement. Block cursor is used if \a desc has block buffers.
+    result(SQLHSTMT stmt, bool wide, const result_columns_ptr& desc)
+        : stmt_(stmt)
+        , wide_(wide)
+        , desc_(desc)
+        , columns_(desc->columns_)
+        , ctypes_(desc->ctypes_)
+        , blocks_(desc->blocks_)
+        , rows_fetched_(0)
+        , block_row_(0)
+        , throw_on_error_(wide, stmt, SQL_HANDLE_STMT)
+    {
+        cells_.reserve(columns_.size());
 
-        max_column_size = (min)(max_column_size, MAX_READ_BUFFER_SIZE);
-        column_char_buf_.resize(max_column_size);
+        if (!blocks_.empty())
+            bind_block();
     }
 
     ~result()
@@ -327,136 +440,151 @@ public:
         // and take care of youself
 
         SQLFreeStmt(stmt_, SQL_CLOSE);
+
+        // Statement handle is reused by cached statement, so return it to row by row fetching
+        if (!blocks_.empty())
+            unbind_block();
     }
 
     template<typename T>
     bool operator()(T* data, typename boost::enable_if< boost::is_arithmetic<T> >::type* = 0 )
     {
-        typedef typename mpl::at<type_ids_map, T>::type data_pair;
-        typedef typename data_pair::first c_type_id;
-        typedef typename data_pair::second c_type;
-
-        c_type tmp;
-        SQLLEN indicator;
-
-        throw_on_error_("SQLGetData") = SQLGetData(stmt_, fetch_col_, c_type_id::value, &tmp, sizeof(tmp), &indicator);
+        SQLLEN length;
+        const char* v = value(fetch_col_ - 1, length);
 
-        if (SQL_NULL_DATA == indicator)
+        if (!v)
             return false;
 
-        *data = static_cast<T>(tmp);
+        switch(ctypes_[fetch_col_ - 1])
+        {
+        case SQL_C_SBIGINT:
+            {
+                long long tmp;
+                memcpy(&tmp, v, sizeof(tmp));
+                assign_integer(tmp, *data);
+            }
+            break;
+        case SQL_C_DOUBLE:
+            {
+                double tmp;
+                memcpy(&tmp, v, sizeof(tmp));
+                assign_floating(tmp, *data);
+            }
+            break;
+        default:
+            {
+                string text;
+                value_to_text(fetch_col_ - 1, v, length, text);
+
+                if (numeric_limits<T>::is_integer)
+                {
+                    long long tmp;
+                    parse_number(text, tmp);
+                    assign_integer(tmp, *data);
+                }
+                else
+                {
+                    double tmp;
+                    parse_number(text, tmp);
+                    assign_floating(tmp, *data);
+                }
+            }
+        }
 
         return true;
     }
 
     bool operator()(tm* data)
     {
-        TIMESTAMP_STRUCT tmp;
-        SQLLEN indicator;
+        SQLLEN length;
+        const char* v = value(fetch_col_ - 1, length);
 
-        throw_on_error_("SQLGetData") = SQLGetData(stmt_, fetch_col_, SQL_C_TYPE_TIMESTAMP, &tmp, sizeof(tmp), &indicator);
-
-        if (SQL_NULL_DATA == indicator)
+        if (!v)
             return false;
 
-        data->tm_isdst = -1;
-        data->tm_year = tmp.year - 1900;
-        data->tm_mon = tmp.month - 1;
-        data->tm_mday = tmp.day;
-        data->tm_hour = tmp.hour;
-        data->tm_min = tmp.minute;
-        data->tm_sec = tmp.second;
+        if (SQL_C_TYPE_TIMESTAMP == ctypes_[fetch_col_ - 1])
+        {
+            TIMESTAMP_STRUCT tmp;
+            memcpy(&tmp, v, sizeof(tmp));
+            timestamp_to_tm(tmp, *data);
+        }
+        else
+        {
+            string text;
+            value_to_text(fetch_col_ - 1, v, length, text);
+            *data = parse_time(text);
+        }
 
-        // normalize and compute the remaining fields
-#ifdef _WIN32
-        _mkgmtime(data);
-#else
-        mktime(data);
-#endif
         return true;
     }
 
-    bool operator()(string* _data)
+    bool operator()(string* data)
     {
-        SQLLEN indicator;
-        string data;
-
-        SQLRETURN r;
-
-        SQLSMALLINT sqltype = columns_[fetch_col_ - 1].type_;
-        bool        fetch_wchar = sqltype == SQL_WCHAR || sqltype == SQL_WVARCHAR || sqltype == SQL_WLONGVARCHAR;
-        SQLSMALLINT ctype = fetch_wchar ? SQL_C_WCHAR : SQL_C_CHAR;
-        size_t      csize = fetch_wchar ? sizeof(SQLWCHAR) : sizeof(SQLCHAR);
-
-        do
-        {
-            r = throw_on_error_("SQLGetData") = SQLGetData(stmt_, fetch_col_, ctype, &column_char_buf_[0], column_char_buf_.size(), &indicator);
+        SQLLEN length;
+        const char* v = value(fetch_col_ - 1, length);
 
-            if (SQL_NULL_DATA == indicator)
-                return false;
-
-            SQLLEN bytes_read = (min)(indicator, (SQLLEN)(column_char_buf_.size() - csize));
-
-            if (fetch_wchar)
-            {
-                utf_to_utf<char>(
-                    (SQLWCHAR*)&column_char_buf_[0]
-                  , (SQLWCHAR*)(&column_char_buf_[0] + bytes_read)
-                  , std::back_inserter(data)
-                  );
-            }
-            else
-                data.append(column_char_buf_.begin(), column_char_buf_.begin() + bytes_read);
-        } while(SQL_SUCCESS_WITH_INFO == r);
-
-        _data->swap(data);
+        if (!v)
+            return false;
 
+        value_to_text(fetch_col_ - 1, v, length, *data);
         return true;
     }
 
     bool operator()(ostream* data)
     {
-        SQLLEN indicator;
-        SQLRETURN r;
-
-        SQLSMALLINT sqltype = columns_[fetch_col_ - 1].type_;
-        bool        fetch_wchar = sqltype == SQL_WCHAR || sqltype == SQL_WVARCHAR || sqltype == SQL_WLONGVARCHAR;
-        SQLSMALLINT ctype = fetch_wchar ? SQL_C_WCHAR : SQL_C_BINARY;
-        size_t      csize = fetch_wchar ? sizeof(SQLWCHAR) : 0;
-
-        do
-        {
-            r = throw_on_error_("SQLGetData") = SQLGetData(stmt_, fetch_col_, ctype, &column_char_buf_[0], column_char_buf_.size(), &indicator);
+        SQLLEN length;
+        const char* v = value(fetch_col_ - 1, length);
 
-            if (SQL_NULL_DATA == indicator)
-                return false;
+        if (!v)
+            return false;
 
-            SQLLEN bytes_read = (min)(indicator, (SQLLEN)(column_char_buf_.size() - csize));
+        SQLSMALLINT ctype = ctypes_[fetch_col_ - 1];
 
-            if (fetch_wchar)
-            {
-                utf_to_utf<char>(
-                    (SQLWCHAR*)&column_char_buf_[0]
-                  , (SQLWCHAR*)(&column_char_buf_[0] + bytes_read)
-                  , std::ostreambuf_iterator<char>(*data)
-                  );
-            }
-            else
-                data->write(&column_char_buf_[0], bytes_read);
-        } while(SQL_SUCCESS_WITH_INFO == r);
+        // Binary data is written as is, not as hex string
+        if (SQL_C_BINARY == ctype || SQL_C_CHAR == ctype)
+            data->write(v, length);
+        else
+        {
+            string text;
+            value_to_text(fetch_col_ - 1, v, length, text);
+            data->write(text.data(), text.size());
+        }
 
         return true;
     }
 
     virtual next_row has_next()
     {
-        // not supported by odbc
+        // known only inside of fetched block
+        if (block_row_ + 1 < rows_fetched_)
+            return next_row_exists;
+
         return next_row_unknown;
     }
 
     virtual bool next()
     {
-        SQLRETURN r = SQLFetch(stmt_);
+        // Keep capacity of arena for the next row
+        cells_.clear();
+        arena_.clear();
+
+        if (!blocks_.empty())
+        {
+            if (++block_row_ < rows_fetched_)
+                return true;
+
+            SQLRETURN r = fetch_row();
+
+            if (r == SQL_NO_DATA)
+                return false;
+
+            throw_on_error_("SQLFetch") = r;
+
+            block_row_ = 0;
+            return rows_fetched_ > 0;
+        }
+
+        SQLRETURN r = fetch_row();
 
         if(r == SQL_SUCCESS || r == SQL_SUCCESS_WITH_INFO)
             return true;
@@ -477,14 +605,13 @@ public:
 
     virtual bool is_null(int col)
     {
-        char buf[4];
-        SQLLEN indicator;
-        SQLRETURN r = SQLGetData(stmt_, col + 1, SQL_C_DEFAULT, buf, 0, &indicator);
+        if (col < 0 || col >= cols())
+            throw invalid_column(col);
 
-        if (!SQL_SUCCEEDED(r))
-            throw_on_error_("SQLGetData") = SQLGetData(stmt_, col + 1, SQL_C_DEFAULT, buf, sizeof(buf), &indicator);
+        if (!blocks_.empty())
+            return SQL_NULL_DATA == blocks_[col].indicators_[block_row_];
 
-        return indicator == SQL_NULL_DATA;
+        return SQL_NULL_DATA == read_cells(col).indicator_;
     }
 
     virtual int cols()
@@ -517,11 +644,268 @@ public:
     }
 
 private:
+    // Fetch next row or block. Columns are described again by the next execution if fetch fails,
+    // because bound buffers may not match columns changed by schema modification.
+    SQLRETURN fetch_row()
+    {
+        SQLRETURN r = SQLFetch(stmt_);
+
+        if (SQL_ERROR == r)
+            desc_->valid_ = false;
+
+        return r;
+    }
+
+    // Bind all columns to column-wise arrays of block cursor, so single SQLFetch reads the whole block.
+    void bind_block()
+    {
+        // Driver without block cursors support, remember it for the next executions
+        if (!SQL_SUCCEEDED(SQLSetStmtAttr(stmt_, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)desc_->block_size_, 0)))
+        {
+            blocks_.clear();
+            return;
+        }
+
+        try
+        {
+            throw_on_error_("SQLSetStmtAttr") = SQLSetStmtAttr(stmt_, SQL_ATTR_ROW_BIND_TYPE, (SQLPOINTER)SQL_BIND_BY_COLUMN, 0);
+            throw_on_error_("SQLSetStmtAttr") = SQLSetStmtAttr(stmt_, SQL_ATTR_ROWS_FETCHED_PTR, &rows_fetched_, 0);
+
+            for(size_t col = 0; col < blocks_.size(); ++col)
+            {
+                column_block& b = blocks_[col];
+                throw_on_error_("SQLBindCol") = SQLBindCol(stmt_, (SQLUSMALLINT)(col + 1), ctypes_[col], &b.values_[0], b.size_, &b.indicators_[0]);
+            }
+        }
+        catch(...)
+        {
+            desc_->valid_ = false;
+            unbind_block();
+            throw;
+        }
+    }
+
+    void unbind_block()
+    {
+        SQLFreeStmt(stmt_, SQL_UNBIND);
+        SQLSetStmtAttr(stmt_, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)1, 0);
+        SQLSetStmtAttr(stmt_, SQL_ATTR_ROWS_FETCHED_PTR, 0, 0);
+    }
+
+    // Return value of column col in current row or 0 if it is NULL
+    const char* value(int col, SQLLEN& length)
+    {
+        if (col < 0 || col >= cols())
+            throw invalid_column(col);
+
+        if (!blocks_.empty())
+            return block_value(col, length);
+
+        const cell& c = read_cells(col);
+
+        if (SQL_NULL_DATA == c.indicator_)
+            return 0;
+
+        length = c.indicator_;
+        return arena_.empty() ? "" : &arena_[0] + c.offset_;
+    }
+
+    const char* block_value(int col, SQLLEN& length)
+    {
+        const column_block& b = blocks_[col];
+        SQLLEN indicator = b.indicators_[block_row_];
+
+        if (SQL_NULL_DATA == indicator)
+            return 0;
+
+        SQLSMALLINT ctype = ctypes_[col];
+        SQLLEN terminator = SQL_C_CHAR == ctype ? 1 : SQL_C_WCHAR == ctype ? sizeof(SQLWCHAR) : 0;
+
+        // Driver has described column size incorrectly
+        if (SQL_NO_TOTAL == indicator || indicator > b.size_ - terminator)
+            throw edba_error("edba::backend::odbc value of column " + columns_[col].name_ +
+                " was truncated by block cursor, turn it off with @odbc_block_size=1");
+
+        length = indicator;
+        return &b.values_[b.size_ * block_row_];
+    }
+
+    // Read columns of current row up to col into arena, columns already read are not touched.
+    // SQLGetData can`t go back to previous columns, so all columns before col are read too.
+    const cell& read_cells(int col)
+    {
+        while (cells_.size() <= (size_t)col)
+        {
+            SQLUSMALLINT column = (SQLUSMALLINT)(cells_.size() + 1);
+            SQLSMALLINT ctype = ctypes_[column - 1];
+
+            cell c;
+            c.offset_ = arena_.size() + (sizeof(double) - arena_.size() % sizeof(double)) % sizeof(double);
+
+            if (SQL_C_SBIGINT == ctype || SQL_C_DOUBLE == ctype || SQL_C_TYPE_TIMESTAMP == ctype)
+            {
+                SQLLEN size = SQL_C_TYPE_TIMESTAMP == ctype ? sizeof(TIMESTAMP_STRUCT) : sizeof(long long);
+                arena_.resize(c.offset_ + size);
+                throw_on_error_("SQLGetData") = SQLGetData(stmt_, column, ctype, &arena_[c.offset_], size, &c.indicator_);
+            }
+            else
+            {
+                // Long values are read by chunks, arena grows up to the whole value
+                SQLLEN terminator = SQL_C_CHAR == ctype ? 1 : SQL_C_WCHAR == ctype ? sizeof(SQLWCHAR) : 0;
+                SQLLEN chunk = MAX_READ_BUFFER_SIZE;
+                SQLLEN length = 0;
+
+                for(;;)
+                {
+                    arena_.resize(c.offset_ + length + chunk);
+
+                    SQLLEN indicator;
+                    SQLRETURN r = SQLGetData(stmt_, column, ctype, &arena_[c.offset_ + length], chunk, &indicator);
+
+                    if (SQL_NO_DATA == r)
+                        break;
+
+                    throw_on_error_("SQLGetData") = r;
+
+                    if (SQL_NULL_DATA == indicator)
+                    {
+                        length = SQL_NULL_DATA;
+                        break;
+                    }
+
+                    bool truncated = SQL_NO_TOTAL == indicator || indicator > chunk - terminator;
+                    length += truncated ? chunk - terminator : indicator;
+
+                    if (SQL_SUCCESS_WITH_INFO != r || !truncated)
+                        break;
+
+                    // Read the rest at once if driver knows its size
+                    chunk = SQL_NO_TOTAL == indicator ? chunk * 2 : indicator - (chunk - terminator) + terminator;
+                }
+
+                c.indicator_ = length;
+                arena_.resize(c.offset_ + (SQL_NULL_DATA == length ? 0 : length));
+            }
+
+            cells_.push_back(c);
+        }
+
+        return cells_[col];
+    }
+
+    static void timestamp_to_tm(const TIMESTAMP_STRUCT& ts, tm& data)
+    {
+        data = tm();
+        data.tm_isdst = -1;
+        data.tm_year = ts.year - 1900;
+        data.tm_mon = ts.month - 1;
+        data.tm_mday = ts.day;
+        data.tm_hour = ts.hour;
+        data.tm_min = ts.minute;
+        data.tm_sec = ts.second;
+
+        // normalize and compute the remaining fields
+#ifdef _WIN32
+        _mkgmtime(&data);
+#else
+        mktime(&data);
+#endif
+    }
+
+    // Format date and time values the same way as drivers do when they are read as SQL_C_CHAR,
+    // fraction of second is printed in nanoseconds without trailing zeros
+    static void timestamp_to_text(SQLSMALLINT type, const TIMESTAMP_STRUCT& ts, string& text)
+    {
+        char buf[64];
+        int len = 0;
+
+        if (SQL_TYPE_TIME != type)
+            len += EDBA_SNPRINTF(buf, sizeof(buf), "%04d-%02u-%02u", int(ts.year), unsigned(ts.month), unsigned(ts.day));
+
+        if (SQL_TYPE_DATE != type)
+        {
+            len += EDBA_SNPRINTF(buf + len, sizeof(buf) - len, "%s%02u:%02u:%02u", len ? " " : "",
+                unsigned(ts.hour), unsigned(ts.minute), unsigned(ts.second));
+
+            if (ts.fraction)
+            {
+                len += EDBA_SNPRINTF(buf + len, sizeof(buf) - len, ".%09lu", (unsigned long)ts.fraction);
+                while ('0' == buf[len - 1])
+                    --len;
+            }
+        }
+
+        text.assign(buf, len);
+    }
+
+    // Convert value of column col to text, binary values are converted to hex string as ODBC does
+    void value_to_text(int col, const char* v, SQLLEN length, string& text)
+    {
+        switch(ctypes_[col])
+        {
+        case SQL_C_SBIGINT:
+            {
+                long long tmp;
+                memcpy(&tmp, v, sizeof(tmp));
+
+                char buf[32];
+                EDBA_SNPRINTF(buf, sizeof(buf), "%lld", tmp);
+                text = buf;
+            }
+            break;
+        case SQL_C_DOUBLE:
+            {
+                double tmp;
+                memcpy(&tmp, v, sizeof(tmp));
+
+                std::ostringstream ss;
+                ss.imbue(std::locale::classic());
+                ss << std::setprecision(std::numeric_limits<double>::digits10 + 1) << tmp;
+                text = ss.str();
+            }
+            break;
+        case SQL_C_TYPE_TIMESTAMP:
+            {
+                TIMESTAMP_STRUCT tmp;
+                memcpy(&tmp, v, sizeof(tmp));
+                timestamp_to_text(columns_[col].type_, tmp, text);
+            }
+            break;
+        case SQL_C_WCHAR:
+            text.clear();
+            utf_to_utf<char>(
+                reinterpret_cast<const SQLWCHAR*>(v)
+              , reinterpret_cast<const SQLWCHAR*>(v + length)
+              , std::back_inserter(text)
+              );
+            break;
+        case SQL_C_BINARY:
+            {
+                static const char digits[] = "0123456789ABCDEF";
+                text.resize(length * 2);
+                for(SQLLEN i = 0; i < length; ++i)
+                {
+                    text[i * 2] = digits[(unsigned char)v[i] >> 4];
+                    text[i * 2 + 1] = digits[(unsigned char)v[i] & 0x0F];
+                }
+            }
+            break;
+        default:
+            text.assign(v, length);
+        }
+    }
+
     SQLHSTMT stmt_;
     bool wide_;
     int fetch_col_;
-    columns_set columns_;
-    vector<char> column_char_buf_;
+    result_columns_ptr desc_;       // Columns shared with statement
+    columns_set& columns_;
+    const vector<SQLSMALLINT>& ctypes_;
+    vector<column_block>& blocks_;  // Bound columns of block cursor, empty if rows are fetched one by one
+    vector<char> arena_;            // Values of columns of current row read by SQLGetData, reused for all rows
+    vector<cell> cells_;            // Columns of current row read into arena_
+    SQLULEN rows_fetched_;          // Number of rows in current block
+    SQLULEN block_row_;             // Index of current row in the block
     error_checker throw_on_error_;
 };
 
@@ -538,6 +922,35 @@ class statement : public backend::statement, public boost::static_visitor<boost:
         SQLSMALLINT nullable_;
     };
 
+    // Column-wise values of single parameter for all rows of parameter array
+    struct param_array
+    {
+        SQLSMALLINT ctype_;
+        SQLSMALLINT sqltype_;
+        SQLULEN column_size_;
+        SQLSMALLINT decimal_digits_;
+        SQLLEN size_;               // size of single value in bytes
+        vector<char> values_;
+        vector<SQLLEN> indicators_;
+    };
+
+    // Return statement handle to execution of single parameter set
+    struct param_array_guard
+    {
+        explicit param_array_guard(SQLHSTMT stmt) : stmt_(stmt) {}
+
+        ~param_array_guard()
+        {
+            SQLFreeStmt(stmt_, SQL_CLOSE);
+            SQLFreeStmt(stmt_, SQL_RESET_PARAMS);
+            SQLSetStmtAttr(stmt_, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)1, 0);
+            SQLSetStmtAttr(stmt_, SQL_ATTR_PARAMS_PROCESSED_PTR, 0, 0);
+            SQLSetStmtAttr(stmt_, SQL_ATTR_PARAM_STATUS_PTR, 0, 0);
+        }
+
+        SQLHSTMT stmt_;
+    };
+
 public:
     statement(
         const common_data* cd
@@ -771,8 +1184,21 @@ public:
     virtual backend::result_ptr query_impl()
     {
         BOOST_AUTO(p, real_exec());
+
+        // Failed execution may be caused by schema modification, so describe columns again next time
+        if (SQL_ERROR == p.second)
+            columns_.reset();
+
         throw_on_error_(p.first) = p.second;
-        return backend::result_ptr(new result(stmt_.get(), cd_->wide_));
+
+        SQLSMALLINT columns_count;
+        throw_on_error_("SQLNumResultCols") = SQLNumResultCols(stmt_.get(), &columns_count);
+
+        // Prepared statement describes columns once and reuses them while their number stays the same
+        if (!prepared_ || !columns_ || !columns_->valid_ || columns_->columns_.size() != (size_t)columns_count)
+            columns_.reset(new result_columns(stmt_.get(), cd_->wide_, columns_count, cd_->block_size_));
+
+        return backend::result_ptr(new result(stmt_.get(), cd_->wide_, columns_));
     }
 
     virtual void exec_impl()
@@ -783,6 +1209,90 @@ public:
             throw_on_error_(p.first) = p.second;
     }
 
+    /// Bind rows as column-wise parameter arrays (SQL_ATTR_PARAMSET_SIZE), so single execution runs
+    /// a chunk of rows. Rows bound by name or with streams are executed one by one, as well as all
+    /// rows when driver doesn`t support parameter arrays.
+    virtual unsigned long long exec_many_impl(const backend::bind_rows& rows)
+    {
+        int cols = (int)bind_by_name_helper_.bindings_count();
+
+        if (rows.rows() < 2 || 0 == cols || rows.has_streams() || !rows.dense(cols))
+            return backend::statement::exec_many_impl(rows);
+
+        reset_bindings_impl();
+
+        const size_t chunk_size = 1024;
+        unsigned long long affected_total = 0;
+
+        for(size_t first = 0; first < rows.rows(); first += chunk_size)
+        {
+            size_t count = (min)(rows.rows() - first, chunk_size);
+
+            vector<param_array> arrays(cols);
+            for(int col = 1; col <= cols; ++col)
+                fill_param_array(rows, first, count, col, arrays[col - 1]);
+
+            SQLULEN processed = 0;
+            vector<SQLUSMALLINT> statuses(count, SQL_PARAM_UNUSED);
+            param_array_guard guard(stmt_.get());
+
+            if (!SQL_SUCCEEDED(SQLSetStmtAttr(stmt_.get(), SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)count, 0)))
+            {
+                // Driver without parameter arrays support
+                if (0 == first)
+                    return backend::statement::exec_many_impl(rows);
+
+                throw_on_error_("SQLSetStmtAttr") = SQL_ERROR;
+            }
+
+            throw_on_error_("SQLSetStmtAttr") = SQLSetStmtAttr(stmt_.get(), SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER)SQL_PARAM_BIND_BY_COLUMN, 0);
+            throw_on_error_("SQLSetStmtAttr") = SQLSetStmtAttr(stmt_.get(), SQL_ATTR_PARAMS_PROCESSED_PTR, &processed, 0);
+            throw_on_error_("SQLSetStmtAttr") = SQLSetStmtAttr(stmt_.get(), SQL_ATTR_PARAM_STATUS_PTR, &statuses[0], 0);
+
+            for(int col = 1; col <= cols; ++col)
+            {
+                param_array& a = arrays[col - 1];
+                throw_on_error_("SQLBindParameter") = SQLBindParameter(
+                    stmt_.get(),
+                    col,
+                    SQL_PARAM_INPUT,
+                    a.ctype_,
+                    a.sqltype_,
+                    a.column_size_,
+                    a.decimal_digits_,
+                    &a.values_[0],
+                    a.size_,
+                    &a.indicators_[0]);
+            }
+
+            BOOST_AUTO(p, real_exec());
+
+            // Driver may report failure of some parameter sets with SQL_SUCCESS_WITH_INFO
+            for(SQLULEN r = 0; r < processed && r < count; ++r)
+            {
+                if (SQL_PARAM_ERROR == statuses[r])
+                {
+                    SQLINTEGER err = 0;
+                    string msg = throw_on_error_.diagnostics(err);
+                    throw edba_error((boost::format("edba::backend::odbc %1% failed for row %2% with error %3% (%4%)") % p.first % (first + r) % msg % err).str());
+                }
+            }
+
+            if(p.second != SQL_NO_DATA)
+                throw_on_error_(p.first) = p.second;
+
+            // Drivers that execute parameter sets as batch report row count of each one as separate result
+            do
+            {
+                SQLLEN affected_rows = 0;
+                if (SQL_SUCCEEDED(SQLRowCount(stmt_.get(), &affected_rows)) && affected_rows > 0)
+                    affected_total += affected_rows;
+            } while(SQL_SUCCEEDED(SQLMoreResults(stmt_.get())));
+        }
+
+        return affected_total;
+    }
+
     pair<const char*, SQLRETURN> real_exec()
     {
         if(prepared_)
@@ -823,6 +1333,113 @@ private:
         }
     }
 
+    // Choose common type of values bound to parameter col in rows [first, first + count) and copy them into array
+    void fill_param_array(const backend::bind_rows& rows, size_t first, size_t count, int col, param_array& a)
+    {
+        param_kind kind = null_param;
+        for(size_t r = 0; r < count; ++r)
+            kind = combine_param_kinds(kind, boost::apply_visitor(param_kind_of(), rows.at(first + r, col)));
+
+        bool described = params_desc_.size() >= (size_t)col;
+        const param_desc& desc = get_param_desc(col, s_generic_varchar_desc);
+
+        a.sqltype_ = desc.data_type_;
+        a.column_size_ = desc.param_size_;
+        a.decimal_digits_ = desc.decimal_digits_;
+        a.indicators_.assign(count, SQL_NULL_DATA);
+
+        if (integer_param == kind)
+        {
+            a.ctype_ = SQL_C_SBIGINT;
+            if (!described)
+            {
+                a.sqltype_ = SQL_BIGINT;
+                a.column_size_ = sizeof(long long);
+                a.decimal_digits_ = 0;
+            }
+
+            fill_numbers<long long>(rows, first, count, col, a);
+        }
+        else if (floating_param == kind)
+        {
+            a.ctype_ = SQL_C_DOUBLE;
+            if (!described)
+            {
+                a.sqltype_ = SQL_DOUBLE;
+                a.column_size_ = sizeof(double);
+                a.decimal_digits_ = 0;
+            }
+
+            fill_numbers<double>(rows, first, count, col, a);
+        }
+        else
+        {
+            if (time_param == kind)
+            {
+                if (!described)
+                    a.sqltype_ = SQL_TYPE_TIMESTAMP;
+                a.decimal_digits_ = 0;
+            }
+
+            bool wide = SQL_WCHAR == a.sqltype_ || SQL_WVARCHAR == a.sqltype_ || SQL_WLONGVARCHAR == a.sqltype_;
+            size_t csize = wide ? sizeof(SQLWCHAR) : sizeof(SQLCHAR);
+
+            // Values encoded as they are sent to driver
+            vector<string> texts(count);
+            size_t max_size = 0;
+
+            for(size_t r = 0; r < count; ++r)
+            {
+                const bind_types_variant& v = rows.at(first + r, col);
+                if (boost::get<null_type>(&v))
+                    continue;
+
+                string s = boost::apply_visitor(param_text(), v);
+                if (wide)
+                {
+                    basic_string<SQLWCHAR> ws = utf_to_utf<SQLWCHAR>(s);
+                    texts[r].assign((const char*)ws.data(), ws.size() * sizeof(SQLWCHAR));
+                }
+                else
+                    texts[r].swap(s);
+
+                max_size = (max)(max_size, texts[r].size());
+            }
+
+            a.ctype_ = wide ? SQL_C_WCHAR : SQL_C_CHAR;
+            a.column_size_ = (max)(max_size / csize, (size_t)1);
+            a.size_ = max_size + csize;     // space for null character
+            a.values_.assign(a.size_ * count, 0);
+
+            for(size_t r = 0; r < count; ++r)
+            {
+                if (!boost::get<null_type>(&rows.at(first + r, col)))
+                {
+                    memcpy(&a.values_[a.size_ * r], texts[r].data(), texts[r].size());
+                    a.indicators_[r] = texts[r].size();
+                }
+            }
+        }
+    }
+
+    template<typename Number>
+    void fill_numbers(const backend::bind_rows& rows, size_t first, size_t count, int col, param_array& a)
+    {
+        a.size_ = sizeof(Number);
+        a.values_.resize(sizeof(Number) * count);
+
+        for(size_t r = 0; r < count; ++r)
+        {
+            const bind_types_variant& v = rows.at(first + r, col);
+            if (boost::get<null_type>(&v))
+                continue;
+
+            Number n = boost::apply_visitor(param_number<Number>(), v);
+            memcpy(&a.values_[sizeof(Number) * r], &n, sizeof(Number));
+            a.indicators_[r] = sizeof(Number);
+        }
+    }
+
     const param_desc& get_param_desc(int column, const param_desc& def) const
     {
         if (params_desc_.size() < (size_t)column)
@@ -892,6 +1509,8 @@ private:
     detail::bind_by_name_helper 
                   bind_by_name_helper_; // Convert statement parameters representation between edba style and odbc
 
+    result_columns_ptr columns_;        // Columns described by the last query
+
     vector<holder_sp> params_;          // Contain data for parameters bound by SQLBindParameter. Data owned here will be referenced by
                                         // ODBC driver during SQLExecute or SQLExecuteDirect invocation
 
@@ -921,6 +1540,13 @@ public:
         else
             throw edba_error("edba::odbc:: @utf property can be either 'narrow' or 'wide'");
 
+        int block_size = ci.get("@odbc_block_size", 1);
+
+        if(block_size < 1)
+            throw edba_error("edba::odbc:: @odbc_block_size property should be positive number of rows");
+
+        block_size_ = block_size;
+
         SQLRETURN r = SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, env_.ptr());
 
         if(!SQL_SUCCEEDED(r))
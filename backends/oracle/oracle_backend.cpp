@@ -1,4 +1,5 @@
 #include <edba/backend/implementation_base.hpp>
+#include <edba/backend/param_kind.hpp>
 #include <edba/detail/handle.hpp>
 #include <edba/errors.hpp>
 
@@ -13,9 +14,15 @@
 #include <boost/move/move.hpp>
 #include <boost/container/vector.hpp>
 #include <boost/mpl/switch.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
 
 #include <boost/foreach.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <limits>
 #include <sstream>
 #include <vector>
 
@@ -92,30 +99,33 @@ struct error_checker
 // Owned by connection object, used by statement and result objects too
 struct common_data
 {
-    common_data() : inside_trans_(false) {}
+    common_data() : inside_trans_(false), stream_results_(false), fetch_rows_(100) {}
 
     oci_handle_env             envhp_;
     oci_handle_error           errhp_;
     oci_handle_service_context svcp_;
     bool                       inside_trans_;
+    bool                       stream_results_;     // @oracle_stream=on
+    ub4                        fetch_rows_;         // @oracle_fetch_rows, rows fetched at once by streamed results
 };
 
 struct column
 {
     std::string name_;
     ub2 type_;
+    ub4 length_;
     oci_handle_define define_;
 
-    std::vector<char> data_;
+    std::vector<char> data_;            // values of all rows of fetched block
     oci_desc_lob lob_;
 
-    sb2 col_fetch_ind_;
-    ub2	col_fetch_size_;
-    ub2	col_fetch_rcode_;
+    std::vector<sb2> col_fetch_ind_;    // indicator, size and return code of each row of fetched block
+    std::vector<ub2> col_fetch_size_;
+    std::vector<ub2> col_fetch_rcode_;
 
-    column() : col_fetch_ind_(0), col_fetch_size_(0), col_fetch_rcode_(0) {}
+    column() : type_(0), length_(0) {}
 
-    void init(OCIEnv* envhp, OCIStmt* stmtp, OCIError* errp, ub4 idx)
+    void describe(OCIStmt* stmtp, OCIError* errp, ub4 idx)
     {
         error_checker ec(errp);
         oci_desc_param parm;
@@ -133,6 +143,7 @@ struct column
         // Get column max length
         ub4 col_length = 0;
         ec = OCIAttrGet(parm.get(), OCI_DTYPE_PARAM, &col_length, 0, OCI_ATTR_DATA_SIZE, errp);
+        length_ = col_length;
 
         // Get column type
         ec = OCIAttrGet(parm.get(), OCI_DTYPE_PARAM, &type_, 0, OCI_ATTR_DATA_TYPE, errp);
@@ -154,9 +165,19 @@ struct column
         {
             type_ = SQLT_STR;
         }
-        
-        if (SQLT_CLOB == type_ ||
-            SQLT_BLOB == type_ )
+    }
+
+    /// Define output buffers for \a rows rows fetched at once. LOB columns support single row only.
+    void define(OCIEnv* envhp, OCIStmt* stmtp, OCIError* errp, ub4 idx, ub4 rows)
+    {
+        error_checker ec(errp);
+        ++idx;
+
+        col_fetch_ind_.assign(rows, 0);
+        col_fetch_size_.assign(rows, 0);
+        col_fetch_rcode_.assign(rows, 0);
+
+        if (is_lob_type())
         {
             ec = OCIDescriptorAlloc(envhp, lob_.ptr().as_void(), OCI_DTYPE_LOB, 0, 0);
 
@@ -164,28 +185,37 @@ struct column
                 stmtp, define_.ptr(), errp, 
                 idx, 
                 &lob_, sizeof(lob_), type_,
-                &col_fetch_ind_, &col_fetch_size_, &col_fetch_rcode_, 
+                &col_fetch_ind_[0], &col_fetch_size_[0], &col_fetch_rcode_[0], 
                 OCI_DEFAULT 
                 );
         }
         else
         {
             // Allocate data, and define output value
-            data_.resize(eval_alloc_size(col_length));
+            size_t value_size = eval_alloc_size(length_);
+            data_.resize(value_size * rows);
 
             ec = OCIDefineByPos(
                 stmtp, define_.ptr(), errp, 
                 idx, 
-                &data_[0], data_.size(), type_,
-                &col_fetch_ind_, &col_fetch_size_, &col_fetch_rcode_, 
+                &data_[0], value_size, type_,
+                &col_fetch_ind_[0], &col_fetch_size_[0], &col_fetch_rcode_[0], 
                 OCI_DEFAULT 
                 );
+
+            if (rows > 1)
+            {
+                ec = OCIDefineArrayOfStruct(
+                    define_.get(), errp, 
+                    value_size, sizeof(sb2), sizeof(ub2), sizeof(ub2)
+                    );
+            }
         }
     }
 
-    bool is_null() const
+    bool is_null(ub4 row) const
     {
-        return -1 == col_fetch_ind_;
+        return -1 == col_fetch_ind_[row];
     }
 
     bool is_lob() const
@@ -193,6 +223,22 @@ struct column
         return !!lob_.get();
     }
 
+    bool is_lob_type() const
+    {
+        return SQLT_CLOB == type_ || SQLT_BLOB == type_;
+    }
+
+    /// Return value fetched for \a row of the block
+    char* data(ub4 row)
+    {
+        return &data_[eval_alloc_size(length_) * row];
+    }
+
+    ub2 size(ub4 row) const
+    {
+        return col_fetch_size_[row];
+    }
+
 private:
     size_t eval_alloc_size(ub4 col_length)
     {
@@ -200,6 +246,47 @@ private:
     }    
 };
 
+/// Described and defined columns of query result. Statement keeps them and reuses by the following executions,
+/// so describe calls, defines and buffers are made only once while statement stays prepared.
+struct result_columns : boost::noncopyable
+{
+    /// Describe and define columns for \a fetch_rows rows fetched at once, 0 means scrollable cursor
+    result_columns(OCIEnv* envhp, OCIStmt* stmtp, OCIError* errhp, ub4 fetch_rows)
+      : size_(0)
+      , requested_rows_(fetch_rows)
+      , fetch_rows_(fetch_rows ? fetch_rows : 1)
+      , valid_(true)
+    {
+        error_checker ec(errhp);
+
+        // Get number of columns in result
+        ec = OCIAttrGet(stmtp, OCI_HTYPE_STMT, &size_, 0, OCI_ATTR_PARAM_COUNT, errhp);
+
+        // Fill columns array. Columns will allocate buffers and 
+        // create defines for output parameter
+        columns_.reset(new column[size_]);
+        for (ub4 i = 0; i < size_; ++i)
+        {
+            columns_[i].describe(stmtp, errhp, i);
+
+            // Only single LOB locator is defined per column
+            if (columns_[i].is_lob_type())
+                fetch_rows_ = 1;
+        }
+
+        for (ub4 i = 0; i < size_; ++i)
+            columns_[i].define(envhp, stmtp, errhp, i, fetch_rows_);
+    }
+
+    boost::scoped_array<column> columns_;
+    ub4 size_;              //!< Number of columns
+    ub4 requested_rows_;    //!< Number of rows fetched at once requested by statement, 0 for scrollable cursor
+    ub4 fetch_rows_;        //!< Number of rows fetched at once
+    bool valid_;            //!< False after failed fetch, then columns are described again by next execution
+};
+
+typedef boost::shared_ptr<result_columns> result_columns_ptr;
+
 class result : public backend::result, public boost::static_visitor<>
 {
     typedef boost::integral_constant<int, SQLT_FLT> sqlt_flt_tag;
@@ -207,34 +294,29 @@ class result : public backend::result, public boost::static_visitor<>
     typedef boost::integral_constant<int, SQLT_UIN> sqlt_uin_tag;
 
 public:
-    result(OCIEnv* envhp, OCISvcCtx* svchp, OCIError* errhp, OCIStmt* stmtp)
+    /// Create result over columns \a cols defined by statement. Statement was executed with OCI_STMT_SCROLLABLE_READONLY
+    /// if cols were defined for scrollable cursor, otherwise result is forward-only and rows are fetched by blocks.
+    result(OCIEnv* envhp, OCISvcCtx* svchp, OCIError* errhp, OCIStmt* stmtp, const result_columns_ptr& cols)
       : envhp_(envhp)
       , svchp_(svchp)
       , stmtp_(stmtp)
       , throw_on_error_(errhp)
+      , cols_(cols)
+      , columns_(cols->columns_.get())
+      , columns_size_(cols->size_)
       , total_rows_(-1)
       , just_initialized_(true)
+      , scrollable_(0 == cols->requested_rows_)
+      , fetch_rows_(cols->fetch_rows_)
+      , block_rows_(0)
+      , row_(0)
+      , last_block_(false)
     {   
-        // Get number of columns in result
-        throw_on_error_ =  OCIAttrGet( 
-            stmtp_
-          , OCI_HTYPE_STMT
-          , &columns_size_
-          , 0
-          , OCI_ATTR_PARAM_COUNT
-          , errhp
-          );
-
-        // Fill columns array. Columns will allocate buffers and 
-        // create defines for output parameter
-        columns_.reset(new column[columns_size_]);
-        for (ub4 i = 0; i < columns_size_; ++i)
-            columns_[i].init(envhp, stmtp, errhp, i);
+        if (!scrollable_)
+            return;
 
         // Evaluate total number of rows
-        throw_on_error_ = OCIStmtFetch2(
-            stmtp_, throw_on_error_.errhp_, 1, OCI_FETCH_LAST, 0, OCI_DEFAULT
-          );
+        fetch_block(1, OCI_FETCH_LAST, 0);
 
         ub4 rows_count;
         throw_on_error_ =  OCIAttrGet( 
@@ -246,6 +328,14 @@ public:
 
     virtual next_row has_next()
     {
+        if (!scrollable_)
+        {
+            if (row_ + 1 < block_rows_)
+                return next_row_exists;
+
+            return last_block_ ? last_row_reached : next_row_unknown;
+        }
+
         if (total_rows_ == (unsigned long long)-1)
             return next_row_unknown;
 
@@ -259,19 +349,14 @@ public:
 
     virtual bool next() 
     {
+        if (!scrollable_)
+            return next_in_block();
+
         sword status;
         if (just_initialized_)
-        {
-            status = throw_on_error_ = OCIStmtFetch2(
-                stmtp_, throw_on_error_.errhp_, 1, OCI_FETCH_FIRST, 0, OCI_DEFAULT
-              );
-        }
+            status = fetch_block(1, OCI_FETCH_FIRST, 0);
         else
-        {
-            status = throw_on_error_ = OCIStmtFetch2(
-                stmtp_, throw_on_error_.errhp_, 1, OCI_FETCH_NEXT, 1, OCI_DEFAULT
-              );
-        }
+            status = fetch_block(1, OCI_FETCH_NEXT, 1);
 
         just_initialized_ = false;
 
@@ -281,7 +366,7 @@ public:
             for (size_t i = 0; i < columns_size_; ++i)
             {
                 column& c = columns_[i];
-                ub2 code = c.col_fetch_rcode_;
+                ub2 code = c.col_fetch_rcode_[0];
             }
         }
 
@@ -318,7 +403,7 @@ public:
         switch(columns_[fetch_col_].type_)
         {
         case SQLT_VNU:
-            convert_number_to_type(&columns_[fetch_col_].data_[0], type_tag(), v, sizeof(T));
+            convert_number_to_type(columns_[fetch_col_].data(row_), type_tag(), v, sizeof(T));
             break;
         default:
             throw edba_error("unsupported conversion");
@@ -364,7 +449,7 @@ public:
               v->assign(c.data_.begin(), c.data_.begin() + (size_t)lob_len_bytes);
         }
         else 
-            v->assign(&c.data_[0], c.col_fetch_size_);
+            v->assign(c.data(row_), c.size(row_));
     }
 
     void operator()(std::ostream* v)
@@ -405,7 +490,7 @@ public:
               v->write(&c.data_[0], lob_len_bytes);
         }
         else 
-            v->write(&columns_[fetch_col_].data_[0], columns_[fetch_col_].col_fetch_size_);
+            v->write(c.data(row_), c.size(row_));
     }
 
     void operator()(std::tm* v)
@@ -419,10 +504,10 @@ public:
         oci_desc_interval_ds iv;
         throw_on_error_ = OCIDescriptorAlloc(envhp_, iv.ptr().as_void(), OCI_DTYPE_INTERVAL_DS, 0, 0);
 
-        ub4 data_len = columns_[fetch_col_].col_fetch_size_;
+        ub4 data_len = columns_[fetch_col_].size(row_);
         throw_on_error_ = OCIDateTimeFromArray(
             envhp_, throw_on_error_.errhp_, 
-            (ub1*)&columns_[fetch_col_].data_[0], data_len, SQLT_TIMESTAMP,
+            (ub1*)columns_[fetch_col_].data(row_), data_len, SQLT_TIMESTAMP,
             dt.get(), iv.get(), 0
           );
 
@@ -456,7 +541,7 @@ public:
 
     virtual bool is_null(int col)
     {
-        return -1 == columns_[col].col_fetch_ind_;
+        return columns_[col].is_null(row_);
     }
 
     virtual int cols() 
@@ -464,7 +549,7 @@ public:
         return columns_size_;
     }
 
-    virtual unsigned long long rows() 
+    virtual boost::uint64_t rows() 
     {
         return total_rows_;
     }
@@ -488,6 +573,40 @@ public:
     }
 
 private:
+    /// Move to the next row of forward-only result, fetching next block when current one is over
+    bool next_in_block()
+    {
+        if (++row_ < block_rows_)
+            return true;
+
+        if (last_block_)
+            return false;
+
+        sword status = fetch_block(fetch_rows_, OCI_FETCH_NEXT, 0);
+
+        // OCI_NO_DATA is returned for the last block even if it contains some rows
+        last_block_ = OCI_NO_DATA == status;
+
+        throw_on_error_ = OCIAttrGet(
+            stmtp_, OCI_HTYPE_STMT, &block_rows_, 0, OCI_ATTR_ROWS_FETCHED, throw_on_error_.errhp_
+          );
+
+        row_ = 0;
+        return block_rows_ > 0;
+    }
+
+    /// Fetch rows into defined buffers. Columns are described again by the next execution if fetch fails,
+    /// because defines may not match select list changed by schema modification.
+    sword fetch_block(ub4 rows, ub2 orientation, sb4 offset)
+    {
+        sword status = OCIStmtFetch2(stmtp_, throw_on_error_.errhp_, rows, orientation, offset, OCI_DEFAULT);
+
+        if (status < 0)
+            cols_->valid_ = false;
+
+        return throw_on_error_ = status;
+    }
+
     void convert_number_to_type(const void* number, sqlt_flt_tag, void* out, size_t out_len)
     {
         const OCINumber* n = reinterpret_cast<const OCINumber*>(number);
@@ -511,21 +630,46 @@ private:
     OCIStmt*          stmtp_;
 
     error_checker throw_on_error_;         //!< Error checker
-    boost::scoped_array<column> columns_;  //!< Columns and defines
+    result_columns_ptr cols_;              //!< Columns and defines shared with statement
+    column* columns_;                      //!< Columns of cols_
     ub4 columns_size_;                     //!< Number of columns in result
     unsigned long long total_rows_;        //!< Total number of rows
     bool just_initialized_;                //!< True before first next call
+    bool scrollable_;                      //!< Statement was executed with OCI_STMT_SCROLLABLE_READONLY
+    ub4 fetch_rows_;                       //!< Number of rows fetched at once
+    ub4 block_rows_;                       //!< Number of rows in fetched block
+    ub4 row_;                              //!< Current row in fetched block
+    bool last_block_;                      //!< Fetched block is the last one
     int fetch_col_;
 };
 
+const ub4 array_dml_rows = 1024;        //!< Maximum number of rows executed by single OCIStmtExecute
+const sb4 max_array_text_size = 32767;  //!< Longer strings are bound row by row
+const sb4 max_number_text_size = 32;    //!< Enough for any number converted to text by param_text
+
 class statement : public backend::statement, public boost::static_visitor<>
 {
+    /// Values of single parameter for all rows of array DML, bound once by OCIBindArrayOfStruct
+    struct param_array
+    {
+        param_array() : type_(SQLT_NON), size_(0), rows_(0), bind_(0) {}
+
+        ub2 type_;
+        sb4 size_;                      //!< Size of single value in bytes
+        ub4 rows_;                      //!< Number of rows buffers are allocated for
+        std::vector<char> values_;
+        std::vector<sb2> indicators_;
+        std::vector<ub2> lengths_;
+        OCIBind* bind_;                 //!< Owned by statement handle
+    };
+
 public:
     statement(const string_ref& query, const common_data* cd, session_stat* stat)
       : backend::statement(stat)
       , cd_(cd)
       , throw_on_error_(cd->errhp_.get())
       , query_(query.begin(), query.end())
+      , arrays_bound_(false)
     {
         throw_on_error_ = OCIStmtPrepare2(
             cd_->svcp_.get()
@@ -650,13 +794,35 @@ public:
 
         bind_unbinded_params();
 
-        throw_on_error_ = OCIStmtExecute(cd_->svcp_.get(), stmtp_.get(), throw_on_error_.errhp_, 0, 0, 0, 0, OCI_STMT_SCROLLABLE_READONLY);
+        // Streamed result is forward-only, so server doesn`t have to walk the whole result to count rows 
+        // before the first row is returned
+        bool stream = cd_->stream_results_ || streamed_result == result_mode_;
+        ub4 fetch_rows = stream ? cd_->fetch_rows_ : 0;
+
+        if (stream)
+        {
+            ub4 prefetch_memory = 0;    // number of prefetched rows is limited by OCI_ATTR_PREFETCH_ROWS only
+            throw_on_error_ = OCIAttrSet(stmtp_.get(), OCI_HTYPE_STMT, &fetch_rows, 0, OCI_ATTR_PREFETCH_ROWS, throw_on_error_.errhp_);
+            throw_on_error_ = OCIAttrSet(stmtp_.get(), OCI_HTYPE_STMT, &prefetch_memory, 0, OCI_ATTR_PREFETCH_MEMORY, throw_on_error_.errhp_);
+        }
+
+        sword status = OCIStmtExecute(cd_->svcp_.get(), stmtp_.get(), throw_on_error_.errhp_, 0, 0, 0, 0, stream ? OCI_DEFAULT : OCI_STMT_SCROLLABLE_READONLY);
+
+        // Failed execution may be caused by schema modification, so describe columns again next time
+        if (status < 0)
+            columns_.reset();
+
+        throw_on_error_ = status;
         
         // emulate auto-commit when we are not inside transaction
         if (!cd_->inside_trans_)
             throw_on_error_ = OCITransCommit(cd_->svcp_.get(), throw_on_error_.errhp_, OCI_DEFAULT);
 
-        return backend::result_ptr(new result(cd_->envhp_.get(), cd_->svcp_.get(), throw_on_error_.errhp_, stmtp_.get()));
+        // Columns are described and defined once and then reused while select list and fetch mode are the same
+        if (!columns_ || !columns_->valid_ || columns_->requested_rows_ != fetch_rows || columns_->size_ != stmt_attr_get<ub4>(OCI_ATTR_PARAM_COUNT))
+            columns_.reset(new result_columns(cd_->envhp_.get(), stmtp_.get(), throw_on_error_.errhp_, fetch_rows));
+
+        return backend::result_ptr(new result(cd_->envhp_.get(), cd_->svcp_.get(), throw_on_error_.errhp_, stmtp_.get(), columns_));
     }
 
     virtual long long sequence_last(std::string const &name)
@@ -693,7 +859,254 @@ public:
         return stmt_attr_get<ub4>(OCI_ATTR_ROW_COUNT);
     }
 
+    /// Execute statement for many rows at once with parameters bound as arrays. Binds are kept by statement
+    /// and reused by the following calls while types and sizes of parameters fit into allocated arrays.
+    virtual unsigned long long exec_many_impl(const bind_rows& rows)
+    {
+        int cols = rows.rows() ? int(rows.row_end(0) - rows.row_begin(0)) : 0;
+
+        if (OCI_STMT_SELECT == stmt_type_ || rows.rows() < 2 || 0 == cols || rows.has_streams() || !rows.dense(cols))
+            return backend::statement::exec_many_impl(rows);
+
+        std::vector<ub2> types(cols);
+        std::vector<sb4> sizes(cols);
+        for(int col = 1; col <= cols; ++col)
+        {
+            if (!param_array_layout(rows, col, types[col - 1], sizes[col - 1]))
+                return backend::statement::exec_many_impl(rows);
+        }
+
+        reset_bindings_impl();
+
+        ub4 capacity = (ub4)(std::min)(rows.rows(), std::size_t(array_dml_rows));
+        allocate_param_arrays(types, sizes, capacity);
+
+        unsigned long long affected_total = 0;
+
+        try
+        {
+            for(std::size_t first = 0; first < rows.rows(); first += capacity)
+            {
+                ub4 count = (ub4)(std::min)(rows.rows() - first, std::size_t(capacity));
+
+                for(int col = 1; col <= cols; ++col)
+                    fill_param_array(rows, first, count, col, arrays_[col - 1]);
+
+                sword status = OCIStmtExecute(cd_->svcp_.get(), stmtp_.get(), throw_on_error_.errhp_, count, 0, 0, 0, OCI_BATCH_ERRORS);
+
+                // Successful rows are applied even if some rows have failed
+                if (OCI_SUCCESS != status && OCI_INVALID_HANDLE != status)
+                {
+                    ub4 failed = stmt_attr_get<ub4>(OCI_ATTR_NUM_DML_ERRORS);
+                    if (failed)
+                        throw_batch_error(first, count, failed);
+                }
+
+                throw_on_error_ = status;
+                affected_total += affected();
+            }
+        }
+        catch(...)
+        {
+            // Rows of all chunks are applied or discarded together when we are not inside transaction
+            if (!cd_->inside_trans_)
+                OCITransRollback(cd_->svcp_.get(), throw_on_error_.errhp_, OCI_DEFAULT);
+
+            throw;
+        }
+
+        // emulate auto-commit when we are not inside transaction
+        if (!cd_->inside_trans_)
+            throw_on_error_ = OCITransCommit(cd_->svcp_.get(), throw_on_error_.errhp_, OCI_DEFAULT);
+
+        return affected_total;
+    }
+
 private:    
+    /// Choose external type and size of values of parameter \a col for all rows.
+    /// Return false if the parameter should be bound row by row.
+    static bool param_array_layout(const bind_rows& rows, int col, ub2& type, sb4& size)
+    {
+        param_kind kind = null_param;
+        bool has_time = false;
+        std::size_t text_size = 1;
+
+        for(std::size_t r = 0; r < rows.rows(); ++r)
+        {
+            const bind_types_variant& v = rows.at(r, col);
+            param_kind k = boost::apply_visitor(param_kind_of(), v);
+            kind = combine_param_kinds(kind, k);
+
+            if (const string_ref* s = boost::get<string_ref>(&v))
+                text_size = (std::max)(text_size, s->size());
+            else if (integer_param == k || floating_param == k)
+                text_size = (std::max)(text_size, std::size_t(max_number_text_size));
+            else if (time_param == k)
+                has_time = true;
+        }
+
+        switch(kind)
+        {
+        case integer_param:
+            type = SQLT_INT;
+            size = sizeof(long long);
+            return true;
+        case floating_param:
+            type = SQLT_FLT;
+            size = sizeof(double);
+            return true;
+        case time_param:
+            type = SQLT_DAT;
+            size = 7;
+            return true;
+        default:
+            type = SQLT_CHR;
+            size = (sb4)text_size;
+            return !has_time && text_size <= std::size_t(max_array_text_size);
+        }
+    }
+
+    /// Grow arrays if they don`t fit values of parameters and bind them if they have moved
+    void allocate_param_arrays(const std::vector<ub2>& types, const std::vector<sb4>& sizes, ub4 rows)
+    {
+        if (arrays_.size() != types.size())
+        {
+            arrays_.resize(types.size());
+            arrays_bound_ = false;
+        }
+
+        for(std::size_t i = 0; i < arrays_.size(); ++i)
+        {
+            param_array& a = arrays_[i];
+
+            if (a.type_ == types[i] && a.size_ >= sizes[i] && a.rows_ >= rows)
+                continue;
+
+            if (a.type_ != types[i])
+                a.size_ = 0;
+
+            a.type_ = types[i];
+            a.size_ = (std::max)(a.size_, sizes[i]);
+            a.rows_ = (std::max)(a.rows_, rows);
+            a.values_.resize(a.size_ * a.rows_);
+            a.indicators_.resize(a.rows_);
+            a.lengths_.resize(a.rows_);
+            arrays_bound_ = false;
+        }
+
+        if (arrays_bound_)
+            return;
+
+        for(std::size_t i = 0; i < arrays_.size(); ++i)
+        {
+            param_array& a = arrays_[i];
+            a.bind_ = 0;
+
+            throw_on_error_ = OCIBindByPos(
+                stmtp_.get()
+              , &a.bind_
+              , throw_on_error_.errhp_
+              , (ub4)(i + 1)
+              , &a.values_[0]
+              , a.size_
+              , a.type_
+              , &a.indicators_[0]
+              , &a.lengths_[0]
+              , 0, 0, 0, OCI_DEFAULT
+              );
+
+            throw_on_error_ = OCIBindArrayOfStruct(a.bind_, throw_on_error_.errhp_, a.size_, sizeof(sb2), sizeof(ub2), 0);
+        }
+
+        arrays_bound_ = true;
+    }
+
+    /// Copy values of parameter \a col for \a count rows starting from \a first into array \a a
+    static void fill_param_array(const bind_rows& rows, std::size_t first, ub4 count, int col, param_array& a)
+    {
+        for(ub4 r = 0; r < count; ++r)
+        {
+            const bind_types_variant& v = rows.at(first + r, col);
+            char* p = &a.values_[a.size_ * r];
+
+            if (boost::get<null_type>(&v))
+            {
+                a.indicators_[r] = OCI_IND_NULL;
+                a.lengths_[r] = 0;
+                continue;
+            }
+
+            a.indicators_[r] = OCI_IND_NOTNULL;
+
+            switch(a.type_)
+            {
+            case SQLT_INT:
+                {
+                    long long n = boost::apply_visitor(param_number<long long>(), v);
+                    std::memcpy(p, &n, sizeof(n));
+                    a.lengths_[r] = sizeof(n);
+                }
+                break;
+            case SQLT_FLT:
+                {
+                    double n = boost::apply_visitor(param_number<double>(), v);
+                    std::memcpy(p, &n, sizeof(n));
+                    a.lengths_[r] = sizeof(n);
+                }
+                break;
+            case SQLT_DAT:
+                {
+                    // Oracle DATE: century and year in excess-100 notation, hour, minute and second in excess-1 one
+                    const std::tm& t = boost::get<std::tm>(v);
+                    int year = t.tm_year + 1900;
+                    p[0] = (char)(year / 100 + 100);
+                    p[1] = (char)(year % 100 + 100);
+                    p[2] = (char)(t.tm_mon + 1);
+                    p[3] = (char)t.tm_mday;
+                    p[4] = (char)(t.tm_hour + 1);
+                    p[5] = (char)(t.tm_min + 1);
+                    p[6] = (char)(t.tm_sec + 1);
+                    a.lengths_[r] = 7;
+                }
+                break;
+            default:
+                if (const string_ref* s = boost::get<string_ref>(&v))
+                {
+                    std::memcpy(p, s->begin(), s->size());
+                    a.lengths_[r] = (ub2)s->size();
+                }
+                else
+                {
+                    std::string str = boost::apply_visitor(param_text(), v);
+                    std::memcpy(p, str.data(), str.size());
+                    a.lengths_[r] = (ub2)str.size();
+                }
+            }
+        }
+    }
+
+    /// Throw error of the first failed row reported by execution with OCI_BATCH_ERRORS
+    void throw_batch_error(std::size_t first, ub4 count, ub4 failed)
+    {
+        oci_handle_error row_errhp;
+        throw_on_error_ = OCIHandleAlloc(cd_->envhp_.get(), row_errhp.ptr().as_void(), OCI_HTYPE_ERROR, 0, 0);
+        throw_on_error_ = OCIParamGet(throw_on_error_.errhp_, OCI_HTYPE_ERROR, throw_on_error_.errhp_, row_errhp.ptr().as_void(), 0);
+
+        ub4 row = 0;
+        throw_on_error_ = OCIAttrGet(row_errhp.get(), OCI_HTYPE_ERROR, &row, 0, OCI_ATTR_DML_ROW_OFFSET, throw_on_error_.errhp_);
+
+        sb4 code = 0;
+        char errbuf[1024] = {0};
+        OCIErrorGet(row_errhp.get(), 1, 0, &code, (text*)errbuf, (ub4) sizeof(errbuf), OCI_HTYPE_ERROR);
+
+        std::ostringstream error_message;
+        error_message << "oracle: " << errbuf << "(error " << code << ") in row " << first + row
+                      << ", " << failed << " of " << count << " rows failed";
+
+        throw edba_error(error_message.str());
+    }
+
+
     void do_bind(const void *v, size_t len, ub2 type) 
     {        
         // remember data to bind it later
@@ -731,6 +1144,9 @@ private:
 
     void bind_unbinded_params()
     {
+        // Binds of array DML are replaced by binds of single row
+        arrays_bound_ = false;
+
         BOOST_FOREACH(const bind_bound& bound, bind_bounds_)
         {
             int oci_ind_null;
@@ -804,6 +1220,9 @@ private:
     std::vector<bind_bound> bind_bounds_;  //!< Bindings bounds from bind_buf_
     boost::container::vector<oci_desc_datetime> dt_holder_;
     boost::container::vector<oci_desc_lob> lob_holder_;
+    result_columns_ptr columns_;           //!< Columns defined by the last query
+    std::vector<param_array> arrays_;      //!< Parameters of array DML
+    bool arrays_bound_;                    //!< Parameters are bound to arrays_
     int bind_col_;
 };
 
@@ -815,6 +1234,20 @@ public:
         string_ref username = ci.get("User");
         string_ref password = ci.get("Password"); 
         string_ref conn_string = ci.get("ConnectionString");
+
+        string_ref stream = ci.get("@oracle_stream", "off");
+
+        if (boost::algorithm::iequals(stream, "on"))
+            stream_results_ = true;
+        else if (!boost::algorithm::iequals(stream, "off"))
+            throw edba_error("oracle: @oracle_stream property should be either on or off");
+
+        int fetch_rows = ci.get("@oracle_fetch_rows", 100);
+
+        if (fetch_rows < 1)
+            throw edba_error("oracle: @oracle_fetch_rows property should be positive number of rows");
+
+        fetch_rows_ = fetch_rows;
         
         throw_on_error_ = OCIEnvNlsCreate(envhp_.ptr(), OCI_THREADED, 0, 0, 0, 0, 0, 0, g_utf8_charset_id, g_utf8_charset_id);
         throw_on_error_ = OCIHandleAlloc(envhp_.get(), errhp_.ptr().as_void(), OCI_HTYPE_ERROR, 0, 0);
@@ -10,6 +10,7 @@
 
 #include <sstream>
 #include <vector>
+#include <deque>
 #include <limits>
 #include <iomanip>
 
@@ -18,14 +19,37 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 namespace edba { namespace backend { namespace postgres { namespace {
 
 const std::string g_backend("PgSQL");
 const std::string g_engine("PgSQL");
 
+const int BOOL_IDENTIFIER_TYPE = 16;
 const int BYTEA_IDENTIFIER_TYPE = 17;
+const int INT8_IDENTIFIER_TYPE = 20;
+const int INT2_IDENTIFIER_TYPE = 21;
+const int INT4_IDENTIFIER_TYPE = 23;
 const int OID_IDENTIFIER_TYPE = 26;
+const int CHAR_IDENTIFIER_TYPE = 18;
+const int NAME_IDENTIFIER_TYPE = 19;
+const int TEXT_IDENTIFIER_TYPE = 25;
+const int JSON_IDENTIFIER_TYPE = 114;
+const int XML_IDENTIFIER_TYPE = 142;
+const int BPCHAR_IDENTIFIER_TYPE = 1042;
+const int VARCHAR_IDENTIFIER_TYPE = 1043;
+const int TIMESTAMPTZ_IDENTIFIER_TYPE = 1184;
+const int NUMERIC_IDENTIFIER_TYPE = 1700;
+const int UUID_IDENTIFIER_TYPE = 2950;
+const int JSONB_IDENTIFIER_TYPE = 3802;
+
+/// Seconds between 1970-01-01 and 2000-01-01
+const long long PG_EPOCH_OFFSET = 946684800;
+const int FLOAT4_IDENTIFIER_TYPE = 700;
+const int FLOAT8_IDENTIFIER_TYPE = 701;
+const int DATE_IDENTIFIER_TYPE = 1082;
+const int TIMESTAMP_IDENTIFIER_TYPE = 1114;
 
 typedef enum {
     lo_type,
@@ -35,13 +59,58 @@ typedef enum {
 /// Data owned by connection object by also required by statement object
 struct common_data
 {
-    common_data() : conn_(0), inside_transaction_(false), blob_(bytea_type) {}
+    common_data() : conn_(0), inside_transaction_(false), blob_(bytea_type), integer_datetimes_(false), binary_results_(false) {}
 
     PGconn* conn_;
     bool inside_transaction_;
     blob_type blob_;
+    bool integer_datetimes_;    // server stores timestamps as 64 bit microseconds
+    bool binary_results_;       // request query results in binary format
 };
 
+/// Return number of days since 2000-01-01 which is the PostgreSQL epoch
+long long days_since_pg_epoch(int y, unsigned m, unsigned d)
+{
+    // Algorithm from http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+    y -= m <= 2;
+    const long long era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<long long>(doe) - 719468 - 10957;
+}
+
+/// Fill date part of \a t from number of days since 2000-01-01
+void date_from_pg_days(long long days, std::tm& t)
+{
+    // Algorithm from http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+    long long z = days + 10957 + 719468;
+    const long long era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    const long long y = static_cast<long long>(yoe) + era * 400 + (m <= 2);
+
+    t.tm_year = int(y - 1900);
+    t.tm_mon = int(m - 1);
+    t.tm_mday = int(d);
+    t.tm_yday = int(days - days_since_pg_epoch(int(y), 1, 1));
+    t.tm_wday = int(((days + 6) % 7 + 7) % 7); // 2000-01-01 was Saturday
+    t.tm_isdst = -1;
+}
+
+/// Read \a size bytes in network byte order
+boost::uint64_t read_network_order(const char* p, int size)
+{
+    boost::uint64_t v = 0;
+    for(int i = 0; i < size; ++i)
+        v = (v << 8) | static_cast<unsigned char>(p[i]);
+    return v;
+}
+
 void emptyNoticeProcessor(void *, const char *)
 {
 }
@@ -79,18 +148,91 @@ public:
 
 class result : public backend::result, public boost::static_visitor<>
 {
+    typedef enum
+    {
+        text_column,        // text format or binary format that equals text one
+        int2_column,
+        int4_column,
+        int8_column,
+        oid_column,
+        bool_column,
+        float4_column,
+        float8_column,
+        numeric_column,
+        date_column,
+        timestamp_column,
+        timestamptz_column,
+        bytea_column,
+        uuid_column,
+        jsonb_column,
+        unsupported_column
+    } column_kind;
+
 public:
-    result(PGresult *res, PGconn *conn) :
+    ///
+    /// Create result from \a res. If \a streaming is true then \a res is the first part of result
+    /// received in single row mode and the rest is fetched in next().
+    ///
+    result(PGresult *res, const common_data* data, bool streaming = false) :
       res_(res),
-      conn_(conn),
+      conn_(data->conn_),
+      data_(data),
       rows_(PQntuples(res)),
       cols_(PQnfields(res)),
-      current_(-1)
+      current_(-1),
+      integer_datetimes_(data->integer_datetimes_),
+      streaming_(streaming),
+      finished_(!streaming)
     {
+        if(streaming_ && PQresultStatus(res_) == PGRES_TUPLES_OK)
+            drain();
+
+        // Choose decoder once per column
+        kinds_.resize(cols_, text_column);
+        for(int c = 0; c < cols_; ++c)
+        {
+            if(PQfformat(res_, c) == 0)
+                continue;
+
+            switch(PQftype(res_, c))
+            {
+            case INT2_IDENTIFIER_TYPE:          kinds_[c] = int2_column; break;
+            case INT4_IDENTIFIER_TYPE:          kinds_[c] = int4_column; break;
+            case INT8_IDENTIFIER_TYPE:          kinds_[c] = int8_column; break;
+            case OID_IDENTIFIER_TYPE:           kinds_[c] = oid_column; break;
+            case BOOL_IDENTIFIER_TYPE:          kinds_[c] = bool_column; break;
+            case FLOAT4_IDENTIFIER_TYPE:        kinds_[c] = float4_column; break;
+            case FLOAT8_IDENTIFIER_TYPE:        kinds_[c] = float8_column; break;
+            case NUMERIC_IDENTIFIER_TYPE:       kinds_[c] = numeric_column; break;
+            case DATE_IDENTIFIER_TYPE:          kinds_[c] = date_column; break;
+            case TIMESTAMP_IDENTIFIER_TYPE:     kinds_[c] = timestamp_column; break;
+            case TIMESTAMPTZ_IDENTIFIER_TYPE:   kinds_[c] = timestamptz_column; break;
+            case BYTEA_IDENTIFIER_TYPE:         kinds_[c] = bytea_column; break;
+            case UUID_IDENTIFIER_TYPE:          kinds_[c] = uuid_column; break;
+            case JSONB_IDENTIFIER_TYPE:         kinds_[c] = jsonb_column; break;
+            case CHAR_IDENTIFIER_TYPE:
+            case NAME_IDENTIFIER_TYPE:
+            case TEXT_IDENTIFIER_TYPE:
+            case JSON_IDENTIFIER_TYPE:
+            case XML_IDENTIFIER_TYPE:
+            case BPCHAR_IDENTIFIER_TYPE:
+            case VARCHAR_IDENTIFIER_TYPE:       kinds_[c] = text_column; break;
+            default:                            kinds_[c] = unsupported_column;
+            }
+        }
     }
 
     virtual ~result()
     {
+        try
+        {
+            if(!finished_)
+                cancel();
+        }
+        catch(...)
+        {
+        }
+
         PQclear(res_);
     }
 
@@ -98,14 +240,19 @@ public:
     {
         if(current_ + 1 < rows_)
             return next_row_exists;
-        else
+        else if(finished_)
             return last_row_reached;
+        else
+            return next_row_unknown;
     }
 
     virtual bool next()
     {
         ++current_;
-        return current_ < rows_;
+        if(current_ < rows_)
+            return true;
+
+        return !finished_ && fetch_part();
     }
 
     virtual bool fetch(int col, const fetch_types_variant& v)
@@ -119,22 +266,157 @@ public:
         return true;
     }
 
+    virtual bool fetch_int64(int col, long long& v)
+    {
+        if(do_isnull(col))
+            return false;
+
+        fetch_col_ = col;
+        (*this)(&v);
+        return true;
+    }
+
+    virtual bool fetch_double(int col, double& v)
+    {
+        if(do_isnull(col))
+            return false;
+
+        fetch_col_ = col;
+        (*this)(&v);
+        return true;
+    }
+
+    virtual bool fetch_text(int col, std::string& v)
+    {
+        if(do_isnull(col))
+            return false;
+
+        fetch_col_ = col;
+        (*this)(&v);
+        return true;
+    }
+
     template<typename T>
     void operator()(T* v, typename boost::enable_if< boost::is_arithmetic<T> >::type* = 0)
     {
-        parse_number(string_ref(PQgetvalue(res_, current_, fetch_col_), PQgetlength(res_, current_, fetch_col_)), *v);
+        switch(kinds_[fetch_col_])
+        {
+        case text_column:
+            parse_number(string_ref(value(), length()), *v);
+            break;
+        case int2_column:
+        case int4_column:
+        case int8_column:
+        case oid_column:
+        case bool_column:
+            assign_integer(binary_integer(), *v);
+            break;
+        case float4_column:
+        case float8_column:
+            assign_floating(binary_floating(), *v);
+            break;
+        case numeric_column:
+            if (std::numeric_limits<T>::is_integer)
+                parse_number(numeric_to_string(), *v);
+            else
+                assign_floating(numeric_to_double(), *v);
+            break;
+        default:
+            throw bad_value_cast();
+        }
     }
 
     void operator()(std::string* v)
     {
-        v->assign(PQgetvalue(res_, current_, fetch_col_),PQgetlength(res_, current_, fetch_col_));
+        char buf[64];
+        int len = 0;
+
+        switch(kinds_[fetch_col_])
+        {
+        case text_column:
+        case bytea_column:
+            v->assign(value(), length());
+            return;
+        case jsonb_column:
+            // Binary jsonb is a version byte followed by text
+            if (length() < 1)
+                throw bad_value_cast();
+            v->assign(value() + 1, length() - 1);
+            return;
+        case bool_column:
+            v->assign(binary_integer() ? "t" : "f");
+            return;
+        case int2_column:
+        case int4_column:
+        case int8_column:
+        case oid_column:
+            len = EDBA_SNPRINTF(buf, sizeof(buf), "%lld", binary_integer());
+            break;
+        case float4_column:
+            len = EDBA_SNPRINTF(buf, sizeof(buf), "%.*g", std::numeric_limits<float>::digits10 + 1, binary_floating());
+            break;
+        case float8_column:
+            len = EDBA_SNPRINTF(buf, sizeof(buf), "%.*g", std::numeric_limits<double>::digits10 + 1, binary_floating());
+            break;
+        case numeric_column:
+            *v = numeric_to_string();
+            return;
+        case date_column:
+        case timestamp_column:
+        case timestamptz_column:
+            {
+                int usec = 0;
+                std::tm t = binary_time(usec);
+                len = int(strftime(buf, sizeof(buf), kinds_[fetch_col_] == date_column ? "%Y-%m-%d" : "%Y-%m-%d %H:%M:%S", &t));
+                if (usec)
+                {
+                    len += EDBA_SNPRINTF(buf + len, sizeof(buf) - len, ".%06d", usec);
+                    while (buf[len - 1] == '0')
+                        --len;
+                }
+            }
+            break;
+        case uuid_column:
+            {
+                const char* hex = "0123456789abcdef";
+                const char* p = value();
+                if (length() != 16)
+                    throw bad_value_cast();
+                for(int i = 0; i < 16; ++i)
+                {
+                    if (i == 4 || i == 6 || i == 8 || i == 10)
+                        buf[len++] = '-';
+                    buf[len++] = hex[static_cast<unsigned char>(p[i]) >> 4];
+                    buf[len++] = hex[static_cast<unsigned char>(p[i]) & 0x0f];
+                }
+            }
+            break;
+        default:
+            throw pqerror("binary format of column type is not supported, use @result_format=text");
+        }
+
+        v->assign(buf, len);
     }
 
     void operator()(std::ostream* v)
     {
+        if (kinds_[fetch_col_] != text_column && kinds_[fetch_col_] != bytea_column && kinds_[fetch_col_] != oid_column)
+        {
+            std::string tmp;
+            (*this)(&tmp);
+            v->write(tmp.c_str(), tmp.size());
+            return;
+        }
+
         switch(PQftype(res_, fetch_col_))
         {
             case BYTEA_IDENTIFIER_TYPE: {
+                if (kinds_[fetch_col_] == bytea_column)
+                {
+                    v->write(value(), length());
+                    break;
+                }
+
                 unsigned char *val = (unsigned char*)PQgetvalue(res_, current_, fetch_col_);
                 size_t len = 0;
 
@@ -189,7 +471,22 @@ public:
 
     void operator()(std::tm* v)
     {
-        *v = parse_time(PQgetvalue(res_, current_, fetch_col_));
+        switch(kinds_[fetch_col_])
+        {
+        case text_column:
+            *v = parse_time(PQgetvalue(res_, current_, fetch_col_));
+            break;
+        case date_column:
+        case timestamp_column:
+        case timestamptz_column:
+            {
+                int usec;
+                *v = binary_time(usec);
+            }
+            break;
+        default:
+            throw bad_value_cast();
+        }
     }
 
     virtual bool is_null(int col)
@@ -204,6 +501,9 @@ public:
 
     virtual boost::uint64_t rows()
     {
+        if(streaming_)
+            return boost::uint64_t(-1);
+
         return boost::uint64_t(PQntuples(res_));
     }
 
@@ -227,18 +527,301 @@ private:
             throw invalid_column(c);
     }
 
+    /// Receive next part of streamed result, return false at the end of result
+    bool fetch_part()
+    {
+        for(;;)
+        {
+            PGresult* r = PQgetResult(conn_);
+            if(!r)
+            {
+                finished_ = true;
+                return false;
+            }
+
+            switch(PQresultStatus(r))
+            {
+            case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            case PGRES_TUPLES_CHUNK:
+#endif
+                PQclear(res_);
+                res_ = r;
+                rows_ = PQntuples(res_);
+                current_ = 0;
+                if(rows_ > 0)
+                    return true;
+                break;
+            case PGRES_TUPLES_OK:
+                // Final empty result, keep it for columns description
+                PQclear(res_);
+                res_ = r;
+                rows_ = 0;
+                current_ = 0;
+                drain();
+                return false;
+            default:
+                {
+                    std::string msg = pqerror::message("fetching of streamed result failed", r);
+                    PQclear(r);
+                    drain();
+                    throw edba_error(msg);
+                }
+            }
+        }
+    }
+
+    /// Read all pending results
+    void drain()
+    {
+        while(PGresult* r = PQgetResult(conn_))
+            PQclear(r);
+
+        finished_ = true;
+    }
+
+    /// Stop receiving of streamed result abandoned before its end
+    void cancel()
+    {
+        // Cancelled statement would abort user transaction, so remaining rows are read and dropped instead
+        if(!data_->inside_transaction_)
+        {
+            if(PGcancel* c = PQgetCancel(conn_))
+            {
+                char err[256];
+                PQcancel(c, err, sizeof(err));
+                PQfreeCancel(c);
+            }
+        }
+
+        drain();
+    }
+
     bool do_isnull(int col)
     {
         check(col);
         return PQgetisnull(res_,current_,col) ? true : false;
     }
 
+    const char* value()
+    {
+        return PQgetvalue(res_, current_, fetch_col_);
+    }
+
+    int length()
+    {
+        return PQgetlength(res_, current_, fetch_col_);
+    }
+
+    void check_length(int expected)
+    {
+        if (length() != expected)
+            throw bad_value_cast();
+    }
+
+    long long binary_integer()
+    {
+        switch(kinds_[fetch_col_])
+        {
+        case bool_column:
+            check_length(1);
+            return value()[0] ? 1 : 0;
+        case int2_column:
+            check_length(2);
+            return static_cast<boost::int16_t>(read_network_order(value(), 2));
+        case int4_column:
+            check_length(4);
+            return static_cast<boost::int32_t>(read_network_order(value(), 4));
+        case oid_column:
+            check_length(4);
+            return static_cast<boost::uint32_t>(read_network_order(value(), 4));
+        default:
+            check_length(8);
+            return static_cast<long long>(read_network_order(value(), 8));
+        }
+    }
+
+    double binary_floating()
+    {
+        if (kinds_[fetch_col_] == float4_column)
+        {
+            check_length(4);
+            boost::uint32_t bits = static_cast<boost::uint32_t>(read_network_order(value(), 4));
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            return f;
+        }
+
+        check_length(8);
+        boost::uint64_t bits = read_network_order(value(), 8);
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        return d;
+    }
+
+    /// Decode date, timestamp or timestamptz column. Timestamps with time zone are converted to local time.
+    std::tm binary_time(int& usec)
+    {
+        std::tm t = std::tm();
+        usec = 0;
+
+        if (kinds_[fetch_col_] == date_column)
+        {
+            check_length(4);
+            date_from_pg_days(static_cast<boost::int32_t>(read_network_order(value(), 4)), t);
+            return t;
+        }
+
+        long long seconds;
+        if (integer_datetimes_)
+        {
+            check_length(8);
+            long long micro = static_cast<long long>(read_network_order(value(), 8));
+            seconds = micro / 1000000;
+            usec = int(micro % 1000000);
+            if (usec < 0)
+            {
+                usec += 1000000;
+                --seconds;
+            }
+        }
+        else
+        {
+            double d = binary_floating();
+            seconds = static_cast<long long>(floor(d));
+            usec = int((d - floor(d)) * 1000000);
+        }
+
+        if (kinds_[fetch_col_] == timestamptz_column)
+        {
+            time_t unix_time = static_cast<time_t>(seconds + PG_EPOCH_OFFSET);
+            if (!EDBA_LOCALTIME(&unix_time, &t))
+                throw bad_value_cast();
+            return t;
+        }
+
+        long long days = seconds / 86400;
+        long long day_seconds = seconds % 86400;
+        if (day_seconds < 0)
+        {
+            day_seconds += 86400;
+            --days;
+        }
+
+        date_from_pg_days(days, t);
+        t.tm_hour = int(day_seconds / 3600);
+        t.tm_min = int(day_seconds / 60 % 60);
+        t.tm_sec = int(day_seconds % 60);
+        return t;
+    }
+
+    /// Binary numeric is: number of base 10000 digits, weight of first digit, sign, display scale and digits
+    void numeric_header(int& ndigits, int& weight, int& sign, int& dscale)
+    {
+        if (length() < 8)
+            throw bad_value_cast();
+
+        const char* p = value();
+        ndigits = static_cast<boost::int16_t>(read_network_order(p, 2));
+        weight = static_cast<boost::int16_t>(read_network_order(p + 2, 2));
+        sign = static_cast<int>(read_network_order(p + 4, 2));
+        dscale = static_cast<boost::int16_t>(read_network_order(p + 6, 2));
+
+        if (ndigits < 0 || length() != 8 + ndigits * 2)
+            throw bad_value_cast();
+    }
+
+    int numeric_digit(int i)
+    {
+        return static_cast<int>(read_network_order(value() + 8 + i * 2, 2));
+    }
+
+    double numeric_to_double()
+    {
+        int ndigits, weight, sign, dscale;
+        numeric_header(ndigits, weight, sign, dscale);
+
+        if (sign == 0xC000)
+            return std::numeric_limits<double>::quiet_NaN();
+
+        double v = 0;
+        for(int i = 0; i < ndigits; ++i)
+            v = v * 10000 + numeric_digit(i);
+
+        v *= pow(10000.0, weight - ndigits + 1);
+        return sign == 0x4000 ? -v : v;
+    }
+
+    std::string numeric_to_string()
+    {
+        int ndigits, weight, sign, dscale;
+        numeric_header(ndigits, weight, sign, dscale);
+
+        if (sign == 0xC000)
+            return "NaN";
+
+        std::string s;
+        if (sign == 0x4000)
+            s += '-';
+
+        // Integer part
+        if (weight < 0)
+            s += '0';
+        for(int i = 0; i <= weight; ++i)
+        {
+            int d = i < ndigits ? numeric_digit(i) : 0;
+            char buf[8];
+            int len = EDBA_SNPRINTF(buf, sizeof(buf), i == 0 ? "%d" : "%04d", d);
+            s.append(buf, len);
+        }
+
+        // Fractional part with dscale decimal digits
+        if (dscale > 0)
+        {
+            s += '.';
+            for(int i = weight + 1, written = 0; written < dscale; ++i)
+            {
+                int d = i >= 0 && i < ndigits ? numeric_digit(i) : 0;
+                char buf[8];
+                EDBA_SNPRINTF(buf, sizeof(buf), "%04d", d);
+                for(int j = 0; j < 4 && written < dscale; ++j, ++written)
+                    s += buf[j];
+            }
+        }
+
+        return s;
+    }
+
     PGresult *res_;
     PGconn *conn_;
+    const common_data* data_;
     int rows_;
     int cols_;
     int current_;
     int fetch_col_;
+    bool integer_datetimes_;
+    bool streaming_;
+    bool finished_;
+    std::vector<column_kind> kinds_;
+};
+
+/// Statement queued into pipeline with a copy of its bindings
+struct queued_statement
+{
+    queued_statement() : prepared_(false), result_format_(0), expects_rows_(false), res_(0), affected_(0) {}
+
+    backend::statement_ptr stmt_;       // keep server side prepared statement alive
+    std::string query_;                 // prepared statement name or query text
+    bool prepared_;
+    std::vector<std::string> values_;
+    std::vector<bool> nulls_;
+    std::vector<int> formats_;
+    int result_format_;
+    bool expects_rows_;
+
+    PGresult* res_;                     // result of query until it is taken
+    unsigned long long affected_;
+    std::string error_;
 };
 
 class statement : public backend::statement, public boost::static_visitor<>
@@ -284,6 +867,7 @@ public:
       , params_pvalues_(bind_by_name_helper_.bindings_count(), 0)
       , params_plengths_(bind_by_name_helper_.bindings_count(), 0)
       , params_set_(bind_by_name_helper_.bindings_count(), null_param)
+      , params_scratch_(bind_by_name_helper_.bindings_count() * 8 + 1)
     {
         std::ostringstream ss;
         ss.imbue(std::locale::classic());
@@ -305,6 +889,8 @@ public:
 
             if(PQresultStatus(r) != PGRES_COMMAND_OK)
                 throw pqerror(r,"statement preparation failed");
+
+            describe_params();
         }
     }
 
@@ -367,16 +953,65 @@ public:
         v.apply_visitor(*this);
     }
 
+    virtual void bind_null_impl(int col)
+    {
+        check(col);
+        bind_col_ = col;
+        (*this)(null);
+    }
+
+    virtual void bind_int64_impl(int col, long long v)
+    {
+        check(col);
+        bind_integer(col, v);
+    }
+
+    virtual void bind_double_impl(int col, double v)
+    {
+        check(col);
+        bind_floating(col, v, std::numeric_limits<double>::digits10 + 1);
+    }
+
+    virtual void bind_text_impl(int col, const string_ref& v)
+    {
+        check(col);
+        bind_col_ = col;
+        (*this)(v);
+    }
+
     template<typename T>
-    void operator()(T v, typename boost::enable_if< boost::is_arithmetic<T> >::type* = 0)
+    void operator()(T v, typename boost::enable_if< boost::is_integral<T> >::type* = 0)
     {
-        std::ostringstream ss;
-        ss.imbue(std::locale::classic());
-        if(!std::numeric_limits<T>::is_integer)
-            ss << std::setprecision(std::numeric_limits<T>::digits10+1);
-        ss << v;
-        params_values_[bind_col_ - 1] = ss.str();
-        params_set_[bind_col_ - 1] = text_param;
+        if (std::numeric_limits<T>::is_signed || static_cast<unsigned long long>(v) <= static_cast<unsigned long long>((std::numeric_limits<long long>::max)()))
+            bind_integer(bind_col_, static_cast<long long>(v));
+        else
+        {
+            char buf[32];
+            int len = EDBA_SNPRINTF(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(v));
+            bind_text_value(bind_col_, buf, len);
+        }
+    }
+
+    void operator()(float v)
+    {
+        bind_floating(bind_col_, v, std::numeric_limits<float>::digits10 + 1);
+    }
+
+    void operator()(double v)
+    {
+        bind_floating(bind_col_, v, std::numeric_limits<double>::digits10 + 1);
+    }
+
+    void operator()(long double v)
+    {
+        if (server_param_type(bind_col_) == FLOAT8_IDENTIFIER_TYPE || server_param_type(bind_col_) == FLOAT4_IDENTIFIER_TYPE)
+            bind_floating(bind_col_, static_cast<double>(v), 0);
+        else
+        {
+            char buf[64];
+            int len = EDBA_SNPRINTF(buf, sizeof(buf), "%.*Lg", std::numeric_limits<long double>::digits10 + 1, v);
+            bind_text_value(bind_col_, buf, len);
+        }
     }
 
     void operator()(const string_ref& v)
@@ -388,8 +1023,23 @@ public:
 
     void operator()(const std::tm& v)
     {
-        params_values_[bind_col_ - 1] = format_time(v);
-        params_set_[bind_col_ - 1] = text_param;
+        int type = server_param_type(bind_col_);
+        if (data_->integer_datetimes_ && (TIMESTAMP_IDENTIFIER_TYPE == type || DATE_IDENTIFIER_TYPE == type))
+        {
+            long long days = days_since_pg_epoch(v.tm_year + 1900, v.tm_mon + 1, v.tm_mday);
+            if (DATE_IDENTIFIER_TYPE == type)
+                bind_binary(bind_col_, static_cast<boost::uint64_t>(days), 4);
+            else
+            {
+                long long seconds = days * 86400 + v.tm_hour * 3600 + v.tm_min * 60 + v.tm_sec;
+                bind_binary(bind_col_, static_cast<boost::uint64_t>(seconds * 1000000), 8);
+            }
+            return;
+        }
+
+        char buf[64];
+        size_t len = strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &v);
+        bind_text_value(bind_col_, buf, int(len));
     }
 
     void operator()(std::istream* in)
@@ -467,7 +1117,33 @@ public:
         params_values_[bind_col_ - 1].swap(tmp);
     }
 
-    void real_query()
+    void fill_params(std::vector<char const *>& values, std::vector<int>& lengths, std::vector<int>& formats)
+    {
+        values.assign(bind_by_name_helper_.bindings_count(),0);
+        lengths.assign(bind_by_name_helper_.bindings_count(),0);
+        formats.assign(bind_by_name_helper_.bindings_count(),0);
+        for(unsigned i = 0; i < bind_by_name_helper_.bindings_count(); i++)
+        {
+            if(params_set_[i]!=null_param)
+            {
+                if(params_pvalues_[i]!=0)
+                {
+                    values[i]=params_pvalues_[i];
+                    lengths[i]=params_plengths_[i];
+                }
+                else
+                {
+                    values[i]=params_values_[i].c_str();
+                    lengths[i]=params_values_[i].size();
+                }
+
+                if(params_set_[i]==binary_param)
+                    formats[i]=1;
+            }
+        }
+    }
+
+    void real_query(int result_format = 0)
     {
         char const * const *pvalues = 0;
         int *plengths = 0;
@@ -477,28 +1153,7 @@ public:
         std::vector<int> formats;
         if(bind_by_name_helper_.bindings_count() > 0)
         {
-            values.resize(bind_by_name_helper_.bindings_count(),0);
-            lengths.resize(bind_by_name_helper_.bindings_count(),0);
-            formats.resize(bind_by_name_helper_.bindings_count(),0);
-            for(unsigned i = 0; i < bind_by_name_helper_.bindings_count(); i++)
-            {
-                if(params_set_[i]!=null_param)
-                {
-                    if(params_pvalues_[i]!=0)
-                    {
-                        values[i]=params_pvalues_[i];
-                        lengths[i]=params_plengths_[i];
-                    }
-                    else
-                    {
-                        values[i]=params_values_[i].c_str();
-                        lengths[i]=params_values_[i].size();
-                    }
-
-                    if(params_set_[i]==binary_param)
-                        formats[i]=1;
-                }
-            }
+            fill_params(values, lengths, formats);
             pvalues=&values.front();
             plengths=&lengths.front();
             pformats=&formats.front();
@@ -519,7 +1174,7 @@ public:
                 pvalues,
                 plengths,
                 pformats, // format - text
-                0 // result format - text
+                result_format
                 );
         }
         else {
@@ -530,19 +1185,22 @@ public:
                 pvalues,
                 plengths,
                 pformats, // format - text
-                0 // result format - text
+                result_format
                 );
         }
     }
 
     virtual backend::result_ptr query_impl()
     {
-        real_query();
+        if(streamed_result == result_mode_)
+            return streamed_query();
+
+        real_query(data_->binary_results_ ? 1 : 0);
         switch(PQresultStatus(res_))
         {
         case PGRES_TUPLES_OK:
         {
-            boost::intrusive_ptr<result> ptr(new result(res_, data_->conn_));
+            boost::intrusive_ptr<result> ptr(new result(res_, data_));
             res_ = 0;
             return ptr;
         }
@@ -617,6 +1275,115 @@ public:
         return 0;
     }
 
+#ifdef LIBPQ_HAS_PIPELINING
+    /// Send rows in pipeline mode, so there is single network round trip per chunk of rows 
+    /// instead of one per row. Note that rows between synchronization points are executed
+    /// in single implicit transaction, so failed row rollbacks other rows of its chunk unless
+    /// explicit transaction is active.
+    virtual unsigned long long exec_many_impl(const backend::bind_rows& rows)
+    {
+        // Large objects are created with separate requests during binding, that is not allowed in pipeline mode
+        if (rows.rows() < 2 || (rows.has_streams() && data_->blob_ == lo_type))
+            return backend::statement::exec_many_impl(rows);
+
+        reset_bindings_impl();
+
+        if (!PQenterPipelineMode(data_->conn_))
+            throw pqerror(data_->conn_, "failed to enter pipeline mode");
+
+        const std::size_t chunk_size = 512;
+
+        unsigned long long affected_total = 0;
+        std::string error;
+        std::vector<char const *> values;
+        std::vector<int> lengths;
+        std::vector<int> formats;
+
+        for(std::size_t first = 0; first < rows.rows() && error.empty(); first += chunk_size)
+        {
+            std::size_t last = (std::min)(rows.rows(), first + chunk_size);
+            std::size_t queued = 0;
+
+            try
+            {
+                for(std::size_t r = first; r < last; ++r, ++queued)
+                {
+                    bind_row(rows, r);
+                    fill_params(values, lengths, formats);
+
+                    char const * const *pvalues = values.empty() ? 0 : &values.front();
+                    int *plengths = lengths.empty() ? 0 : &lengths.front();
+                    int *pformats = formats.empty() ? 0 : &formats.front();
+
+                    int sent = prepared_id_.empty() 
+                        ? PQsendQueryParams(data_->conn_, patched_query().c_str(), bind_by_name_helper_.bindings_count(), 0, pvalues, plengths, pformats, 0)
+                        : PQsendQueryPrepared(data_->conn_, prepared_id_.c_str(), bind_by_name_helper_.bindings_count(), pvalues, plengths, pformats, 0);
+
+                    if (!sent)
+                    {
+                        error = pqerror::message("failed to send statement", data_->conn_);
+                        break;
+                    }
+                }
+            }
+            catch(const std::exception& e)
+            {
+                error = e.what();
+            }
+
+            if (!PQpipelineSync(data_->conn_) && error.empty())
+                error = pqerror::message("failed to sync pipeline", data_->conn_);
+
+            // Read results of all queued statements up to synchronization point
+            std::size_t finished = 0;
+            for(;;)
+            {
+                PGresult* r = PQgetResult(data_->conn_);
+                if (!r)
+                {
+                    if (++finished > queued || PQstatus(data_->conn_) == CONNECTION_BAD)
+                        break;
+                    continue;
+                }
+
+                ExecStatusType status = PQresultStatus(r);
+                if (PGRES_PIPELINE_SYNC == status)
+                {
+                    PQclear(r);
+                    break;
+                }
+                
+                if (PGRES_COMMAND_OK == status)
+                {
+                    char const *s = PQcmdTuples(r);
+                    if (s && *s)
+                        affected_total += atoll(s);
+                }
+                else if (PGRES_TUPLES_OK == status)
+                {
+                    if (error.empty())
+                        error = pqerror::message("Query used instead of statement");
+                }
+                else if (PGRES_PIPELINE_ABORTED != status && error.empty())
+                {
+                    std::ostringstream ss;
+                    ss << "statement execution failed for row " << first + finished;
+                    error = pqerror::message(ss.str().c_str(), r);
+                }
+
+                PQclear(r);
+            }
+        }
+
+        PQexitPipelineMode(data_->conn_);
+
+        if (!error.empty())
+            throw edba_error(error);
+
+        return affected_total;
+    }
+#endif
+
 private:
     void check(int col)
     {
@@ -624,6 +1391,206 @@ private:
             throw invalid_column(col - 1);
     }
 
+public:
+    /// Copy current bindings into \a q so it could be sent later
+    void capture(queued_statement& q)
+    {
+        std::vector<char const *> values;
+        std::vector<int> lengths;
+        fill_params(values, lengths, q.formats_);
+
+        q.prepared_ = !prepared_id_.empty();
+        q.query_ = q.prepared_ ? prepared_id_ : patched_query();
+        q.result_format_ = data_->binary_results_ ? 1 : 0;
+        q.values_.resize(values.size());
+        q.nulls_.resize(values.size());
+        for(size_t i = 0; i < values.size(); ++i)
+        {
+            q.nulls_[i] = values[i] == 0;
+            if(values[i])
+                q.values_[i].assign(values[i], lengths[i]);
+        }
+    }
+
+private:
+    /// Send query and receive its result row by row
+    backend::result_ptr streamed_query()
+    {
+        if(res_)
+        {
+            PQclear(res_);
+            res_ = 0;
+        }
+
+        std::vector<char const *> values;
+        std::vector<int> lengths;
+        std::vector<int> formats;
+        fill_params(values, lengths, formats);
+
+        char const * const *pvalues = values.empty() ? 0 : &values.front();
+        int *plengths = lengths.empty() ? 0 : &lengths.front();
+        int *pformats = formats.empty() ? 0 : &formats.front();
+        int result_format = data_->binary_results_ ? 1 : 0;
+
+        int sent = prepared_id_.empty() 
+            ? PQsendQueryParams(data_->conn_, patched_query().c_str(), bind_by_name_helper_.bindings_count(), 0, pvalues, plengths, pformats, result_format)
+            : PQsendQueryPrepared(data_->conn_, prepared_id_.c_str(), bind_by_name_helper_.bindings_count(), pvalues, plengths, pformats, result_format);
+
+        if(!sent)
+            throw pqerror(data_->conn_, "query execution failed");
+
+#ifdef LIBPQ_HAS_CHUNK_MODE
+        int row_mode = PQsetChunkedRowsMode(data_->conn_, 256);
+#else
+        int row_mode = PQsetSingleRowMode(data_->conn_);
+#endif
+
+        PGresult* r = PQgetResult(data_->conn_);
+        ExecStatusType status = r ? PQresultStatus(r) : PGRES_FATAL_ERROR;
+
+        if(PGRES_SINGLE_TUPLE == status || PGRES_TUPLES_OK == status
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            || PGRES_TUPLES_CHUNK == status
+#endif
+            )
+        {
+            if(row_mode)
+                return backend::result_ptr(new result(r, data_, true));
+
+            // Single row mode was refused, so the whole result is already received
+            backend::result_ptr res(new result(r, data_));
+            while((r = PQgetResult(data_->conn_)) != 0)
+                PQclear(r);
+            return res;
+        }
+
+        std::string msg = 
+            PGRES_COMMAND_OK == status ? pqerror::message("Statement used instread of query") : 
+            r ? pqerror::message("query execution failed ", r) : 
+            pqerror::message("query execution failed ", data_->conn_);
+
+        if(r)
+            PQclear(r);
+
+        while((r = PQgetResult(data_->conn_)) != 0)
+            PQclear(r);
+
+        throw edba_error(msg);
+    }
+
+    /// Get types of parameters inferred by server for prepared statement, they allow to send values in binary format
+    void describe_params()
+    {
+        PGresult* r = PQdescribePrepared(data_->conn_, prepared_id_.c_str());
+
+        if(!r)
+            throw pqerror("Failed to describe prepared statement!");
+
+        BOOST_SCOPE_EXIT((r))
+        {
+            PQclear(r);
+        } BOOST_SCOPE_EXIT_END
+
+        if(PQresultStatus(r) != PGRES_COMMAND_OK)
+            throw pqerror(r, "statement description failed");
+
+        int count = (std::min)(PQnparams(r), int(bind_by_name_helper_.bindings_count()));
+        params_types_.assign(bind_by_name_helper_.bindings_count(), 0);
+        for(int i = 0; i < count; ++i)
+            params_types_[i] = PQparamtype(r, i);
+    }
+
+    /// Return type of parameter inferred by server or 0 if it is unknown (for unprepared statements)
+    int server_param_type(int col) const
+    {
+        return params_types_.empty() ? 0 : int(params_types_[col - 1]);
+    }
+
+    /// Set parameter to \a size lowest bytes of \a v in network byte order
+    void bind_binary(int col, boost::uint64_t v, int size)
+    {
+        char* buf = &params_scratch_[(col - 1) * 8];
+        for(int i = size - 1; i >= 0; --i, v >>= 8)
+            buf[i] = char(v & 0xff);
+
+        params_pvalues_[col - 1] = buf;
+        params_plengths_[col - 1] = size;
+        params_set_[col - 1] = binary_param;
+    }
+
+    void bind_text_value(int col, const char* buf, int len)
+    {
+        params_values_[col - 1].assign(buf, len);
+        params_pvalues_[col - 1] = 0;
+        params_set_[col - 1] = text_param;
+    }
+
+    void bind_integer(int col, long long v)
+    {
+        switch(server_param_type(col))
+        {
+        case INT8_IDENTIFIER_TYPE:
+            bind_binary(col, static_cast<boost::uint64_t>(v), 8);
+            return;
+        case INT4_IDENTIFIER_TYPE:
+            if (v >= (std::numeric_limits<boost::int32_t>::min)() && v <= (std::numeric_limits<boost::int32_t>::max)())
+            {
+                bind_binary(col, static_cast<boost::uint64_t>(v), 4);
+                return;
+            }
+            break;
+        case INT2_IDENTIFIER_TYPE:
+            if (v >= (std::numeric_limits<boost::int16_t>::min)() && v <= (std::numeric_limits<boost::int16_t>::max)())
+            {
+                bind_binary(col, static_cast<boost::uint64_t>(v), 2);
+                return;
+            }
+            break;
+        case BOOL_IDENTIFIER_TYPE:
+            if (v == 0 || v == 1)
+            {
+                bind_binary(col, static_cast<boost::uint64_t>(v), 1);
+                return;
+            }
+            break;
+        case FLOAT8_IDENTIFIER_TYPE:
+        case FLOAT4_IDENTIFIER_TYPE:
+            bind_floating(col, static_cast<double>(v), 0);
+            return;
+        }
+
+        // Let server convert value or report an error for out of range values
+        char buf[32];
+        int len = EDBA_SNPRINTF(buf, sizeof(buf), "%lld", v);
+        bind_text_value(col, buf, len);
+    }
+
+    void bind_floating(int col, double v, int text_precision)
+    {
+        switch(server_param_type(col))
+        {
+        case FLOAT8_IDENTIFIER_TYPE:
+            {
+                boost::uint64_t bits;
+                memcpy(&bits, &v, sizeof(bits));
+                bind_binary(col, bits, 8);
+            }
+            return;
+        case FLOAT4_IDENTIFIER_TYPE:
+            {
+                float f = static_cast<float>(v);
+                boost::uint32_t bits;
+                memcpy(&bits, &f, sizeof(bits));
+                bind_binary(col, bits, 4);
+            }
+            return;
+        }
+
+        char buf[64];
+        int len = EDBA_SNPRINTF(buf, sizeof(buf), "%.*g", text_precision ? text_precision : std::numeric_limits<double>::digits10 + 1, v);
+        bind_text_value(col, buf, len);
+    }
+
     detail::bind_by_name_helper bind_by_name_helper_;
     const common_data* data_;
     PGresult *res_;
@@ -633,131 +1600,1045 @@ private:
     std::vector<char const *> params_pvalues_;
     std::vector<size_t> params_plengths_;
     std::vector<param_type> params_set_;
+    std::vector<Oid> params_types_;     // inferred by server for prepared statements
+    std::vector<char> params_scratch_;  // 8 bytes per parameter for values sent in binary format
     int bind_col_;
 };
 
-class connection : public backend::connection, private common_data
+/// Append \a size lower bytes of \a v in network byte order
+void write_network_order(std::string& out, boost::uint64_t v, int size)
 {
+    for(int i = size - 1; i >= 0; --i)
+        out += static_cast<char>((v >> (i * 8)) & 0xff);
+}
+
+///
+/// Row of bulk writer, values are bound as parameters of statement and encoded into COPY FROM STDIN stream
+/// at the end of row. Encoded rows are buffered and sent by large chunks.
+///
+class copy_row : public backend::statement, public boost::static_visitor<>
+{
+    typedef enum
+    {
+        text_column,        // text, varchar and other types that are sent as text in binary format too
+        bool_column,
+        int2_column,
+        int4_column,
+        int8_column,
+        float4_column,
+        float8_column,
+        date_column,
+        timestamp_column,
+        timestamptz_column,
+        bytea_column,
+        jsonb_column,
+        unsupported_column  // binary format of column type is not known
+    } column_kind;
+
 public:
-    connection(conn_info const &ci, session_monitor* sm) :
-        backend::connection(ci, sm),
-        prepared_id_(0)
+    copy_row(const common_data* data, const string_ref& table, const string_ref& columns, bulk_format format, session_stat* stat)
+      : backend::statement(stat)
+      , data_(data)
+      , binary_(bulk_binary_format == format)
+      , finished_(false)
+      , rows_(0)
+      , bind_col_(0)
     {
-        std::string pq = ci.pgsql_conn_string();
-        string_ref blob = ci.get("@blob","bytea");
+        std::string cols = columns.empty() ? std::string("*") : std::string(columns.begin(), columns.end());
+        std::string tbl(table.begin(), table.end());
 
-        if(boost::algorithm::iequals(blob, "bytea"))
-            blob_ = bytea_type;
-        else if(boost::algorithm::iequals(blob, "lo"))
-            blob_ = lo_type;
-        else
-            throw pqerror("@blob property should be either lo or bytea");
+        // Get names and types of loaded columns
+        std::string probe = "SELECT " + cols + " FROM " + tbl + " LIMIT 0";
+        PGresult* r = PQexec(data_->conn_, probe.c_str());
 
-        try 
+        BOOST_SCOPE_EXIT((r))
         {
-            conn_ = PQconnectdb(pq.c_str());
-            if(!conn_)
-                throw pqerror("failed to create connection object");
-            if(PQstatus(conn_)!=CONNECTION_OK)
-                throw pqerror(conn_, "failed to connect ");
+            PQclear(r);
+        } BOOST_SCOPE_EXIT_END
+
+        if(PQresultStatus(r) != PGRES_TUPLES_OK)
+            throw pqerror(r, "failed to describe columns of bulk writer");
+
+        for(int i = 0; i < PQnfields(r); ++i)
+        {
+            names_.push_back(PQfname(r, i));
+            kinds_.push_back(kind_of(PQftype(r, i)));
+
+            if(binary_ && unsupported_column == kinds_.back())
+                throw pqerror(("binary COPY format of column " + names_.back() + " is not supported, use bulk_text_format").c_str());
         }
-        catch(...) 
+
+        query_ = "COPY " + tbl;
+        if(!columns.empty())
+            query_ += " (" + cols + ")";
+        query_ += " FROM STDIN";
+        if(binary_)
+            query_ += " WITH (FORMAT binary)";
+
+        PGresult* c = PQexec(data_->conn_, query_.c_str());
+
+        BOOST_SCOPE_EXIT((c))
         {
-            if(conn_) {
-                PQfinish(conn_);
-                conn_ = 0;
-            }
+            PQclear(c);
+        } BOOST_SCOPE_EXIT_END
 
-            throw;
+        if(PQresultStatus(c) != PGRES_COPY_IN)
+            throw pqerror(c, "failed to start COPY FROM STDIN");
+
+        if(binary_)
+        {
+            // Signature, flags and header extension length
+            buffer_.assign("PGCOPY\n\377\r\n\0", 11);
+            write_network_order(buffer_, 0, 4);
+            write_network_order(buffer_, 0, 4);
         }
 
-        // Get rid of spam in stderr.
-        // TODO: Probably it should be forwarded to session monitor
-        PQsetNoticeProcessor(conn_, &emptyNoticeProcessor, 0);
+        reset_bindings_impl();
+    }
 
-        // prepare human readable description
-        int major;
-        int minor;
-        version(major, minor);
-        char buf[256];
-        EDBA_SNPRINTF(buf, 256, "PostgreSQL version %d.%d, user is '%s'", major, minor, PQuser(conn_));
-        description_ = buf;
+    virtual ~copy_row()
+    {
+        cancel();
     }
 
-    virtual ~connection()
+    virtual const std::string& patched_query() const
     {
-        PQfinish(conn_);
+        return query_;
     }
 
-    virtual void begin_impl()
+    virtual void reset_bindings_impl()
     {
-        statement::do_simple_exec(conn_, "begin");
-        inside_transaction_ = true;
+        values_.resize(kinds_.size());
+        BOOST_FOREACH(std::string& s, values_)
+            s.clear();
+
+        nulls_.assign(kinds_.size(), true);
     }
 
-    virtual void commit_impl()
+    virtual void bind_impl(int col, bind_types_variant const& v)
     {
-        statement::do_simple_exec(conn_, "commit");
-        inside_transaction_ = false;
+        if(col < 1 || col > int(kinds_.size()))
+            throw invalid_column(col - 1);
+
+        bind_col_ = col;
+        nulls_[col - 1] = false;
+        values_[col - 1].clear();
+
+        v.apply_visitor(*this);
     }
 
-    virtual void rollback_impl()
+    virtual void bind_impl(const string_ref& name, bind_types_variant const& v)
     {
-        try {
-            statement::do_simple_exec(conn_, "rollback");
+        for(std::size_t i = 0; i < names_.size(); ++i)
+        {
+            if(boost::algorithm::iequals(names_[i], name))
+                return bind_impl(int(i + 1), v);
         }
-        catch(...) {}
-        inside_transaction_ = false;
+
+        throw invalid_column(std::string(name.begin(), name.end()));
     }
 
-    virtual backend::statement_ptr prepare_statement_impl(const string_ref& q)
+    virtual backend::result_ptr query_impl()
     {
-        return backend::statement_ptr(new statement(this,q,++prepared_id_, &stat_));
+        throw pqerror("bulk writer row can`t be used as query");
     }
 
-    virtual backend::statement_ptr create_statement_impl(const string_ref& q)
+    virtual void exec_impl()
     {
-        return backend::statement_ptr(new statement(this,q,0, &stat_));
+        throw pqerror("bulk writer row can`t be executed, use bulk_writer::end_row");
     }
 
-    virtual void exec_batch_impl(const string_ref& q)
+    virtual long long sequence_last(std::string const &)
     {
-        if (expand_conditionals_)
-            statement::do_simple_exec(conn_, q.begin());
-        else
-        {
-            // copy whole string to make it null terminated :(
-            std::string tmp(q.begin(), q.end());
-            statement::do_simple_exec(conn_, tmp.c_str());
-        }
+        throw not_supported_by_backend("edba::bulk_writer doesn`t support last_insert_id");
     }
 
-    virtual std::string escape(const string_ref& s)
+    virtual unsigned long long affected()
     {
-        std::vector<char> buf(2 * s.size() + 1);
-        size_t len = PQescapeStringConn(conn_, &buf.front(), s.begin(), s.size(), 0);
-        return std::string(&buf.front(), len);
+        return rows_;
     }
 
-    virtual const std::string& backend()
+    template<typename T>
+    void operator()(T v, typename boost::enable_if< boost::is_integral<T> >::type* = 0)
     {
-        return g_backend;
+        if (std::numeric_limits<T>::is_signed || static_cast<unsigned long long>(v) <= static_cast<unsigned long long>((std::numeric_limits<long long>::max)()))
+            put_integer(static_cast<long long>(v));
+        else
+        {
+            if(binary_ && !is_textual())
+                throw bad_value_cast();
+
+            char buf[32];
+            int len = EDBA_SNPRINTF(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(v));
+            values_[bind_col_ - 1].assign(buf, len);
+        }
     }
-    virtual const std::string& engine()
+
+    void operator()(float v)
     {
-        return g_engine;
+        put_floating(v, std::numeric_limits<float>::digits10 + 1);
     }
-    virtual void version(int& major, int& minor)
+
+    void operator()(double v)
     {
-        int full_ver = PQserverVersion(conn_);
-        major = full_ver / 10000;
-        minor = (full_ver / 100) % 100;
+        put_floating(v, std::numeric_limits<double>::digits10 + 1);
     }
-    virtual const std::string& description()
+
+    void operator()(long double v)
     {
-        return description_;
+        put_floating(static_cast<double>(v), std::numeric_limits<double>::digits10 + 1);
     }
-private:
+
+    void operator()(const string_ref& v)
+    {
+        std::string& out = values_[bind_col_ - 1];
+
+        if(!binary_ || is_textual() || bytea_column == kind())
+        {
+            if(binary_ && jsonb_column == kind())
+                out = '\1';     // jsonb binary format version
+            out.append(v.begin(), v.end());
+            return;
+        }
+
+        switch(kind())
+        {
+        case bool_column:
+            if(boost::algorithm::iequals(v, "t") || boost::algorithm::iequals(v, "true") || boost::algorithm::equals(v, "1"))
+                put_integer(1);
+            else if(boost::algorithm::iequals(v, "f") || boost::algorithm::iequals(v, "false") || boost::algorithm::equals(v, "0"))
+                put_integer(0);
+            else
+                throw bad_value_cast();
+            break;
+        case int2_column:
+        case int4_column:
+        case int8_column:
+            {
+                long long n;
+                parse_number(v, n);
+                put_integer(n);
+            }
+            break;
+        case float4_column:
+        case float8_column:
+            {
+                double n;
+                parse_number(v, n);
+                put_floating(n, 0);
+            }
+            break;
+        default:
+            (*this)(parse_time(std::string(v.begin(), v.end())));
+        }
+    }
+
+    void operator()(const std::tm& v)
+    {
+        if(binary_ && !is_textual())
+        {
+            long long days = days_since_pg_epoch(v.tm_year + 1900, v.tm_mon + 1, v.tm_mday);
+            long long seconds = days * 86400 + v.tm_hour * 3600 + v.tm_min * 60 + v.tm_sec;
+
+            switch(kind())
+            {
+            case date_column:
+                write_network_order(values_[bind_col_ - 1], static_cast<boost::uint64_t>(days), 4);
+                break;
+            case timestamp_column:
+                write_network_order(values_[bind_col_ - 1], static_cast<boost::uint64_t>(seconds * 1000000), 8);
+                break;
+            case timestamptz_column:
+                {
+                    // Values are treated as local time, the same way as server does for text input
+                    std::tm tmp = v;
+                    tmp.tm_isdst = -1;
+                    long long utc = static_cast<long long>(mktime(&tmp)) - PG_EPOCH_OFFSET;
+                    write_network_order(values_[bind_col_ - 1], static_cast<boost::uint64_t>(utc * 1000000), 8);
+                }
+                break;
+            default:
+                throw bad_value_cast();
+            }
+            return;
+        }
+
+        char buf[64];
+        size_t len = strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &v);
+        values_[bind_col_ - 1].assign(buf, len);
+    }
+
+    void operator()(std::istream* in)
+    {
+        if(binary_ && !is_textual() && bytea_column != kind())
+            throw bad_value_cast();
+
+        std::ostringstream ss;
+        ss << in->rdbuf();
+        std::string data = ss.str();
+
+        if(!binary_ && bytea_column == kind())
+        {
+            // Text format of bytea is hex string that starts with \x
+            static const char digits[] = "0123456789abcdef";
+            std::string& out = values_[bind_col_ - 1];
+            out.reserve(data.size() * 2 + 2);
+            out = "\\x";
+            BOOST_FOREACH(char c, data)
+            {
+                out += digits[static_cast<unsigned char>(c) >> 4];
+                out += digits[static_cast<unsigned char>(c) & 0xf];
+            }
+        }
+        else
+            (*this)(string_ref(data));
+    }
+
+    void operator()(null_type)
+    {
+        nulls_[bind_col_ - 1] = true;
+    }
+
+    /// Encode bound values as the next row of COPY stream
+    void end_row()
+    {
+        if(finished_)
+            throw pqerror("bulk writer is already finished");
+
+        if(binary_)
+        {
+            write_network_order(buffer_, kinds_.size(), 2);
+            for(std::size_t i = 0; i < kinds_.size(); ++i)
+            {
+                if(nulls_[i])
+                    write_network_order(buffer_, static_cast<boost::uint32_t>(-1), 4);
+                else
+                {
+                    write_network_order(buffer_, values_[i].size(), 4);
+                    buffer_ += values_[i];
+                }
+            }
+        }
+        else
+        {
+            for(std::size_t i = 0; i < kinds_.size(); ++i)
+            {
+                if(i > 0)
+                    buffer_ += '\t';
+
+                if(nulls_[i])
+                    buffer_ += "\\N";
+                else
+                    append_escaped(values_[i]);
+            }
+            buffer_ += '\n';
+        }
+
+        ++rows_;
+        if(buffer_.size() >= 65536)
+            flush();
+    }
+
+    /// Send data that is already encoded in COPY format
+    void write_raw(std::istream& in)
+    {
+        if(finished_)
+            throw pqerror("bulk writer is already finished");
+
+        flush();
+
+        char buf[65536];
+        while(in.read(buf, sizeof(buf)) || in.gcount() > 0)
+        {
+            if(PQputCopyData(data_->conn_, buf, int(in.gcount())) != 1)
+                throw pqerror(data_->conn_, "failed to send data of COPY FROM STDIN");
+        }
+    }
+
+    unsigned long long finish()
+    {
+        if(finished_)
+            throw pqerror("bulk writer is already finished");
+
+        unsigned long long affected = 0;
+        statement_stat::measure_batch m(&stat_, &query_, static_cast<std::size_t>(rows_), &affected);
+
+        if(binary_)
+            write_network_order(buffer_, static_cast<boost::uint16_t>(-1), 2);
+
+        flush();
+        finished_ = true;
+
+        if(PQputCopyEnd(data_->conn_, 0) != 1)
+            throw pqerror(data_->conn_, "failed to finish COPY FROM STDIN");
+
+        std::string error;
+        while(PGresult* r = PQgetResult(data_->conn_))
+        {
+            if(PQresultStatus(r) == PGRES_COMMAND_OK)
+            {
+                char const *s = PQcmdTuples(r);
+                if(s && *s)
+                    affected = atoll(s);
+            }
+            else if(error.empty())
+                error = pqerror::message("COPY FROM STDIN failed", r);
+
+            PQclear(r);
+        }
+
+        if(!error.empty())
+            throw edba_error(error);
+
+        return affected;
+    }
+
+    /// Abort COPY, never throws
+    void cancel()
+    {
+        if(finished_)
+            return;
+
+        finished_ = true;
+        if(PQputCopyEnd(data_->conn_, "edba::bulk_writer cancelled") == 1)
+        {
+            while(PGresult* r = PQgetResult(data_->conn_))
+                PQclear(r);
+        }
+    }
+
+private:
+    static column_kind kind_of(Oid type)
+    {
+        switch(type)
+        {
+        case BOOL_IDENTIFIER_TYPE: return bool_column;
+        case INT2_IDENTIFIER_TYPE: return int2_column;
+        case INT4_IDENTIFIER_TYPE: return int4_column;
+        case INT8_IDENTIFIER_TYPE: return int8_column;
+        case FLOAT4_IDENTIFIER_TYPE: return float4_column;
+        case FLOAT8_IDENTIFIER_TYPE: return float8_column;
+        case DATE_IDENTIFIER_TYPE: return date_column;
+        case TIMESTAMP_IDENTIFIER_TYPE: return timestamp_column;
+        case TIMESTAMPTZ_IDENTIFIER_TYPE: return timestamptz_column;
+        case BYTEA_IDENTIFIER_TYPE: return bytea_column;
+        case JSONB_IDENTIFIER_TYPE: return jsonb_column;
+        case TEXT_IDENTIFIER_TYPE:
+        case VARCHAR_IDENTIFIER_TYPE:
+        case BPCHAR_IDENTIFIER_TYPE:
+        case NAME_IDENTIFIER_TYPE:
+        case JSON_IDENTIFIER_TYPE:
+            return text_column;
+        default:
+            return unsupported_column;
+        }
+    }
+
+    column_kind kind() const
+    {
+        return kinds_[bind_col_ - 1];
+    }
+
+    /// Column accepts text representation of value
+    bool is_textual() const
+    {
+        return text_column == kind() || jsonb_column == kind() || unsupported_column == kind();
+    }
+
+    void put_integer(long long v)
+    {
+        std::string& out = values_[bind_col_ - 1];
+
+        if(binary_ && !is_textual())
+        {
+            switch(kind())
+            {
+            case bool_column:
+                out = v ? '\1' : '\0';
+                return;
+            case int2_column:
+                if(v < (std::numeric_limits<boost::int16_t>::min)() || v > (std::numeric_limits<boost::int16_t>::max)())
+                    throw bad_value_cast();
+                write_network_order(out, static_cast<boost::uint64_t>(v), 2);
+                return;
+            case int4_column:
+                if(v < (std::numeric_limits<boost::int32_t>::min)() || v > (std::numeric_limits<boost::int32_t>::max)())
+                    throw bad_value_cast();
+                write_network_order(out, static_cast<boost::uint64_t>(v), 4);
+                return;
+            case int8_column:
+                write_network_order(out, static_cast<boost::uint64_t>(v), 8);
+                return;
+            case float4_column:
+            case float8_column:
+                put_floating(static_cast<double>(v), 0);
+                return;
+            default:
+                throw bad_value_cast();
+            }
+        }
+
+        char buf[32];
+        int len = EDBA_SNPRINTF(buf, sizeof(buf), "%lld", v);
+        out.assign(buf, len);
+    }
+
+    void put_floating(double v, int precision)
+    {
+        std::string& out = values_[bind_col_ - 1];
+
+        if(binary_ && !is_textual())
+        {
+            switch(kind())
+            {
+            case float4_column:
+                {
+                    float f = static_cast<float>(v);
+                    boost::uint32_t bits;
+                    memcpy(&bits, &f, 4);
+                    write_network_order(out, bits, 4);
+                }
+                return;
+            case float8_column:
+                {
+                    boost::uint64_t bits;
+                    memcpy(&bits, &v, 8);
+                    write_network_order(out, bits, 8);
+                }
+                return;
+            case int2_column:
+            case int4_column:
+            case int8_column:
+                if(floor(v) != v || fabs(v) > 9.2e18)
+                    throw bad_value_cast();
+                put_integer(static_cast<long long>(v));
+                return;
+            default:
+                throw bad_value_cast();
+            }
+        }
+
+        char buf[64];
+        int len = EDBA_SNPRINTF(buf, sizeof(buf), "%.*g", precision ? precision : std::numeric_limits<double>::digits10 + 1, v);
+        out.assign(buf, len);
+    }
+
+    /// Append value escaped according to COPY text format
+    void append_escaped(const std::string& v)
+    {
+        BOOST_FOREACH(char c, v)
+        {
+            switch(c)
+            {
+            case '\\': buffer_ += "\\\\"; break;
+            case '\t': buffer_ += "\\t"; break;
+            case '\n': buffer_ += "\\n"; break;
+            case '\r': buffer_ += "\\r"; break;
+            default: buffer_ += c;
+            }
+        }
+    }
+
+    void flush()
+    {
+        if(buffer_.empty())
+            return;
+
+        if(PQputCopyData(data_->conn_, buffer_.data(), int(buffer_.size())) != 1)
+            throw pqerror(data_->conn_, "failed to send data of COPY FROM STDIN");
+
+        buffer_.clear();
+    }
+
+    const common_data* data_;
+    bool binary_;
+    bool finished_;
+    std::string query_;
+    std::vector<std::string> names_;
+    std::vector<column_kind> kinds_;
+    std::vector<std::string> values_;
+    std::vector<bool> nulls_;
+    std::string buffer_;
+    unsigned long long rows_;
+    int bind_col_;
+};
+
+class copy_writer : public backend::bulk_writer_iface
+{
+public:
+    copy_writer(copy_row* row) : row_(row)
+    {
+    }
+
+    virtual backend::statement_ptr row()
+    {
+        return row_;
+    }
+
+    virtual void end_row()
+    {
+        row_->end_row();
+    }
+
+    virtual void write_raw(std::istream& in)
+    {
+        row_->write_raw(in);
+    }
+
+    virtual unsigned long long finish()
+    {
+        return row_->finish();
+    }
+
+    virtual unsigned long long skipped()
+    {
+        // COPY fails entirely on the first bad row
+        return 0;
+    }
+
+    virtual void cancel()
+    {
+        row_->cancel();
+    }
+
+private:
+    boost::intrusive_ptr<copy_row> row_;
+};
+
+#ifdef LIBPQ_HAS_PIPELINING
+///
+/// Pipeline keeps statements with copies of their bindings and sends them in pipeline mode on sync(),
+/// so the connection is in ordinary mode between synchronizations and new statements could be prepared.
+///
+class pipeline : public backend::pipeline_iface
+{
+public:
+    pipeline(const common_data* data) : data_(data), synced_(0)
+    {
+    }
+
+    virtual ~pipeline()
+    {
+        BOOST_FOREACH(queued_statement& q, queue_)
+        {
+            if(q.res_)
+                PQclear(q.res_);
+        }
+    }
+
+    virtual std::size_t exec(const backend::statement_ptr& st)
+    {
+        return add(st, false);
+    }
+
+    virtual std::size_t query(const backend::statement_ptr& st)
+    {
+        return add(st, true);
+    }
+
+    virtual void sync()
+    {
+        if(synced_ == queue_.size())
+            return;
+
+        if(!PQenterPipelineMode(data_->conn_))
+            throw pqerror(data_->conn_, "failed to enter pipeline mode");
+
+        std::size_t sent = synced_;
+        while(sent < queue_.size() && send(queue_[sent]))
+            ++sent;
+
+        std::string send_error;
+        if(sent < queue_.size())
+            send_error = pqerror::message("failed to send statement", data_->conn_);
+
+        PQpipelineSync(data_->conn_);
+
+        for(std::size_t i = synced_; i < sent; ++i)
+            receive(queue_[i]);
+
+        while(PGresult* r = PQgetResult(data_->conn_))
+        {
+            bool sync_reached = PQresultStatus(r) == PGRES_PIPELINE_SYNC;
+            PQclear(r);
+            if(sync_reached)
+                break;
+        }
+
+        PQexitPipelineMode(data_->conn_);
+
+        for(std::size_t i = sent; i < queue_.size(); ++i)
+            queue_[i].error_ = send_error;
+
+        synced_ = queue_.size();
+    }
+
+    virtual std::size_t size()
+    {
+        return queue_.size();
+    }
+
+    virtual const std::string& error(std::size_t i)
+    {
+        return at(i).error_;
+    }
+
+    virtual unsigned long long affected(std::size_t i)
+    {
+        return synced(i).affected_;
+    }
+
+    virtual backend::result_ptr result(std::size_t i)
+    {
+        queued_statement& q = synced(i);
+
+        if(!q.expects_rows_)
+            throw pqerror("pipeline statement is not a query");
+
+        if(!q.res_)
+            throw pqerror("result of pipeline query was already taken");
+
+        backend::result_ptr res(new postgres::result(q.res_, data_));
+        q.res_ = 0;
+        return res;
+    }
+
+private:
+    std::size_t add(const backend::statement_ptr& st, bool expects_rows)
+    {
+        statement* pst = dynamic_cast<statement*>(st.get());
+        if(!pst)
+            throw pqerror("statement of other backend can`t be queued into pipeline");
+
+        queue_.push_back(queued_statement());
+        queue_.back().stmt_ = st;
+        queue_.back().expects_rows_ = expects_rows;
+        pst->capture(queue_.back());
+        return queue_.size() - 1;
+    }
+
+    queued_statement& at(std::size_t i)
+    {
+        if(i >= queue_.size())
+            throw pipeline_error(i, pqerror::message("invalid pipeline statement index"));
+
+        return queue_[i];
+    }
+
+    queued_statement& synced(std::size_t i)
+    {
+        queued_statement& q = at(i);
+
+        if(i >= synced_)
+            throw pipeline_error(i, pqerror::message("pipeline statement is not synchronized yet"));
+
+        if(!q.error_.empty())
+            throw pipeline_error(i, q.error_);
+
+        return q;
+    }
+
+    bool send(const queued_statement& q)
+    {
+        int count = int(q.values_.size());
+        std::vector<char const *> values(count);
+        std::vector<int> lengths(count);
+        for(int i = 0; i < count; ++i)
+        {
+            values[i] = q.nulls_[i] ? 0 : q.values_[i].c_str();
+            lengths[i] = int(q.values_[i].size());
+        }
+
+        char const * const *pvalues = values.empty() ? 0 : &values.front();
+        const int *plengths = lengths.empty() ? 0 : &lengths.front();
+        const int *pformats = q.formats_.empty() ? 0 : &q.formats_.front();
+
+        return 0 != (q.prepared_
+            ? PQsendQueryPrepared(data_->conn_, q.query_.c_str(), count, pvalues, plengths, pformats, q.result_format_)
+            : PQsendQueryParams(data_->conn_, q.query_.c_str(), count, 0, pvalues, plengths, pformats, q.result_format_));
+    }
+
+    void receive(queued_statement& q)
+    {
+        bool received = false;
+        while(PGresult* r = PQgetResult(data_->conn_))
+        {
+            received = true;
+
+            switch(PQresultStatus(r))
+            {
+            case PGRES_TUPLES_OK:
+                if(q.expects_rows_ && !q.res_)
+                {
+                    q.res_ = r;
+                    continue;
+                }
+                if(!q.expects_rows_)
+                    set_error(q, pqerror::message("Query used instead of statement"));
+                break;
+            case PGRES_COMMAND_OK:
+                if(q.expects_rows_)
+                    set_error(q, pqerror::message("Statement used instread of query"));
+                else
+                {
+                    char const *s = PQcmdTuples(r);
+                    q.affected_ = s && *s ? atoll(s) : 0;
+                }
+                break;
+            case PGRES_PIPELINE_ABORTED:
+                set_error(q, pqerror::message("statement skipped because of previous error in pipeline"));
+                break;
+            default:
+                set_error(q, pqerror::message("statement execution failed ", r));
+            }
+
+            PQclear(r);
+        }
+
+        if(!received)
+            set_error(q, pqerror::message("no result received", data_->conn_));
+    }
+
+    void set_error(queued_statement& q, const std::string& msg)
+    {
+        if(q.error_.empty())
+            q.error_ = msg;
+    }
+
+    const common_data* data_;
+    std::deque<queued_statement> queue_;
+    std::size_t synced_;
+};
+#endif
+
+class connection : public backend::connection, private common_data
+{
+public:
+    connection(conn_info const &ci, session_monitor* sm) :
+        backend::connection(ci, sm),
+        prepared_id_(0)
+    {
+        std::string pq = ci.pgsql_conn_string();
+        string_ref blob = ci.get("@blob","bytea");
+
+        if(boost::algorithm::iequals(blob, "bytea"))
+            blob_ = bytea_type;
+        else if(boost::algorithm::iequals(blob, "lo"))
+            blob_ = lo_type;
+        else
+            throw pqerror("@blob property should be either lo or bytea");
+
+        string_ref result_format = ci.get("@result_format", "text");
+
+        if(boost::algorithm::iequals(result_format, "binary"))
+            binary_results_ = true;
+        else if(!boost::algorithm::iequals(result_format, "text"))
+            throw pqerror("@result_format property should be either text or binary");
+
+        try 
+        {
+            conn_ = PQconnectdb(pq.c_str());
+            if(!conn_)
+                throw pqerror("failed to create connection object");
+            if(PQstatus(conn_)!=CONNECTION_OK)
+                throw pqerror(conn_, "failed to connect ");
+        }
+        catch(...) 
+        {
+            if(conn_) {
+                PQfinish(conn_);
+                conn_ = 0;
+            }
+
+            throw;
+        }
+
+        const char* integer_datetimes = PQparameterStatus(conn_, "integer_datetimes");
+        integer_datetimes_ = integer_datetimes && 0 == strcmp(integer_datetimes, "on");
+
+        // Get rid of spam in stderr.
+        // TODO: Probably it should be forwarded to session monitor
+        PQsetNoticeProcessor(conn_, &emptyNoticeProcessor, 0);
+
+        // prepare human readable description
+        int major;
+        int minor;
+        version(major, minor);
+        char buf[256];
+        EDBA_SNPRINTF(buf, 256, "PostgreSQL version %d.%d, user is '%s'", major, minor, PQuser(conn_));
+        description_ = buf;
+    }
+
+    virtual ~connection()
+    {
+        PQfinish(conn_);
+    }
+
+    virtual void begin_impl()
+    {
+        statement::do_simple_exec(conn_, "begin");
+        inside_transaction_ = true;
+    }
+
+    virtual void commit_impl()
+    {
+        statement::do_simple_exec(conn_, "commit");
+        inside_transaction_ = false;
+    }
+
+    virtual void rollback_impl()
+    {
+        try {
+            statement::do_simple_exec(conn_, "rollback");
+        }
+        catch(...) {}
+        inside_transaction_ = false;
+    }
+
+    virtual backend::statement_ptr prepare_statement_impl(const string_ref& q)
+    {
+        return backend::statement_ptr(new statement(this,q,++prepared_id_, &stat_));
+    }
+
+    virtual backend::bulk_writer_ptr create_bulk_writer_impl(const string_ref& table, const string_ref& columns, bulk_format format)
+    {
+        return backend::bulk_writer_ptr(new copy_writer(new copy_row(this, table, columns, format, &stat_)));
+    }
+
+    virtual unsigned long long copy_to_impl(const string_ref& q, bulk_format format, const copy_sink& sink)
+    {
+        std::string query = "COPY (" + std::string(q.begin(), q.end()) + ") TO STDOUT";
+        if(bulk_binary_format == format)
+            query += " WITH (FORMAT binary)";
+
+        PGresult* r = PQexec(conn_, query.c_str());
+
+        BOOST_SCOPE_EXIT((r))
+        {
+            PQclear(r);
+        } BOOST_SCOPE_EXIT_END
+
+        if(PQresultStatus(r) != PGRES_COPY_OUT)
+            throw pqerror(r, "failed to start COPY TO STDOUT");
+
+        // Each buffer holds single row, it is passed to sink and freed without any copying
+        char* buf = 0;
+        int len;
+        try
+        {
+            while((len = PQgetCopyData(conn_, &buf, 0)) > 0)
+            {
+                BOOST_SCOPE_EXIT((buf))
+                {
+                    PQfreemem(buf);
+                } BOOST_SCOPE_EXIT_END
+
+                sink(buf, static_cast<std::size_t>(len));
+            }
+        }
+        catch(...)
+        {
+            abort_copy_out();
+            throw;
+        }
+
+        if(-2 == len)
+        {
+            std::string error = pqerror::message("COPY TO STDOUT failed", conn_);
+            abort_copy_out();
+            throw edba_error(error);
+        }
+
+        unsigned long long rows = 0;
+        std::string error;
+        while(PGresult* res = PQgetResult(conn_))
+        {
+            if(PQresultStatus(res) == PGRES_COMMAND_OK)
+            {
+                char const *s = PQcmdTuples(res);
+                if(s && *s)
+                    rows = atoll(s);
+            }
+            else if(error.empty())
+                error = pqerror::message("COPY TO STDOUT failed", res);
+
+            PQclear(res);
+        }
+
+        if(!error.empty())
+            throw edba_error(error);
+
+        return rows;
+    }
+
+#ifdef LIBPQ_HAS_PIPELINING
+    virtual backend::pipeline_ptr create_pipeline_impl()
+    {
+        return backend::pipeline_ptr(new pipeline(this));
+    }
+#endif
+
+    virtual backend::statement_ptr create_statement_impl(const string_ref& q)
+    {
+        return backend::statement_ptr(new statement(this,q,0, &stat_));
+    }
+
+    virtual void exec_batch_impl(const string_ref& q)
+    {
+        if (expand_conditionals_)
+            statement::do_simple_exec(conn_, q.begin());
+        else
+        {
+            // copy whole string to make it null terminated :(
+            std::string tmp(q.begin(), q.end());
+            statement::do_simple_exec(conn_, tmp.c_str());
+        }
+    }
+
+    virtual std::string escape(const string_ref& s)
+    {
+        std::vector<char> buf(2 * s.size() + 1);
+        size_t len = PQescapeStringConn(conn_, &buf.front(), s.begin(), s.size(), 0);
+        return std::string(&buf.front(), len);
+    }
+
+    virtual const std::string& backend()
+    {
+        return g_backend;
+    }
+    virtual const std::string& engine()
+    {
+        return g_engine;
+    }
+    virtual void version(int& major, int& minor)
+    {
+        int full_ver = PQserverVersion(conn_);
+        major = full_ver / 10000;
+        minor = (full_ver / 100) % 100;
+    }
+    virtual const std::string& description()
+    {
+        return description_;
+    }
+private:
+    /// Cancel running COPY TO STDOUT and consume remaining data, never throws
+    void abort_copy_out()
+    {
+        if(PGcancel* cancel = PQgetCancel(conn_))
+        {
+            char errbuf[256];
+            PQcancel(cancel, errbuf, sizeof(errbuf));
+            PQfreeCancel(cancel);
+        }
+
+        char* buf = 0;
+        while(PQgetCopyData(conn_, &buf, 0) > 0)
+            PQfreemem(buf);
+
+        while(PGresult* res = PQgetResult(conn_))
+            PQclear(res);
+    }
+
     unsigned long long prepared_id_;
     std::string description_;
 };
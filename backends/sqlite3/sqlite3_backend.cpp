@@ -5,14 +5,19 @@
 #include <boost/type_traits/is_unsigned.hpp>
 #include <boost/type_traits/is_floating_point.hpp>
 #include <boost/foreach.hpp>
+#include <boost/functional/hash.hpp>
 
+#include <algorithm>
 #include <sstream>
 #include <limits>
 #include <iomanip>
 #include <map>
+#include <list>
+#include <vector>
 
 #include <sqlite3.h>
 
+#include <assert.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -24,6 +29,18 @@ int g_ver_major = (sqlite3_libversion_number() / 1000) % 1000;
 int g_ver_minor = sqlite3_libversion_number() % 1000;
 std::string g_description = std::string("SQLite Version ") + sqlite3_libversion();
 
+bool on_off_property(const conn_info& ci, const char* name)
+{
+    string_ref v = ci.get(name, "off");
+
+    if(boost::algorithm::iequals(v, "on"))
+        return true;
+    if(!boost::algorithm::iequals(v, "off"))
+        throw edba_error(std::string("sqlite3:") + name + " property should be either on or off");
+
+    return false;
+}
+
 class result : public backend::result, public boost::static_visitor<>
 {
 public:
@@ -68,6 +85,34 @@ public:
         return true;
     }
 
+    virtual bool fetch_int64(int col, long long& v)
+    {
+        if (!check_fetch(col))
+            return false;
+
+        v = sqlite3_column_int64(st_, col);
+        return true;
+    }
+
+    virtual bool fetch_double(int col, double& v)
+    {
+        if (!check_fetch(col))
+            return false;
+
+        v = sqlite3_column_double(st_, col);
+        return true;
+    }
+
+    virtual bool fetch_text(int col, std::string& v)
+    {
+        if (!check_fetch(col))
+            return false;
+
+        fetch_col_ = col;
+        (*this)(&v);
+        return true;
+    }
+
     template<typename T>
     void operator()(T* data, typename boost::enable_if< boost::is_signed<T> >::type* = 0)
     {
@@ -108,9 +153,10 @@ public:
 
     void operator()(std::ostream* data)
     {
-        char const *txt = (char const *)sqlite3_column_text(st_, fetch_col_);
+        // Blob is written as is, without conversion to null terminated text
+        char const *blob = (char const *)sqlite3_column_blob(st_, fetch_col_);
         int size = sqlite3_column_bytes(st_, fetch_col_);
-        data->write(txt,size);
+        data->write(blob, size);
     }
 
     void operator()(std::tm *data)
@@ -166,6 +212,14 @@ public:
         return name;
     }
 private:
+    bool check_fetch(int col)
+    {
+        if(col < 0 || col >= cols_)
+            throw invalid_column(col);
+
+        return sqlite3_column_type(st_, col) != SQLITE_NULL;
+    }
+
     sqlite3_stmt *st_;
     sqlite3 *conn_;
 
@@ -208,6 +262,10 @@ public:
     {
         reset_stat();
         sqlite3_clear_bindings(st_);
+        blobs_.clear();
+#ifndef NDEBUG
+        static_guards_.clear();
+#endif
     }
 
     virtual void bind_impl(int col, bind_types_variant const& v)
@@ -233,6 +291,41 @@ public:
         v.apply_visitor(*this);
     }
 
+    virtual void bind_null_impl(int col)
+    {
+        reset_stat();
+        bind_col_ = col;
+        (*this)(null);
+    }
+
+    virtual void bind_int64_impl(int col, long long v)
+    {
+        reset_stat();
+        bind_col_ = col;
+        check_bind(sqlite3_bind_int64(st_, bind_col_, static_cast<sqlite3_int64>(v)));
+    }
+
+    virtual void bind_double_impl(int col, double v)
+    {
+        reset_stat();
+        bind_col_ = col;
+        check_bind(sqlite3_bind_double(st_, bind_col_, v));
+    }
+
+    virtual void bind_text_impl(int col, const string_ref& v)
+    {
+        reset_stat();
+        bind_col_ = col;
+        (*this)(v);
+    }
+
+    virtual void bind_zeroblob_impl(int col, boost::uint64_t size)
+    {
+        reset_stat();
+        bind_col_ = col;
+        check_bind(sqlite3_bind_zeroblob64(st_, bind_col_, static_cast<sqlite3_uint64>(size)));
+    }
+
     void operator()(null_type)
     {
         check_bind(sqlite3_bind_null(st_, bind_col_));
@@ -259,7 +352,18 @@ public:
 
     void operator()(const string_ref& v)
     {
-        check_bind(sqlite3_bind_text(st_, bind_col_, v.begin(), int(v.size()), SQLITE_TRANSIENT));
+        bool is_static = static_bind == bind_mode_;
+        check_bind(sqlite3_bind_text(st_, bind_col_, v.begin(), int(v.size()), is_static ? SQLITE_STATIC : SQLITE_TRANSIENT));
+
+#ifndef NDEBUG
+        if (is_static)
+        {
+            static_guard g = { v.begin(), v.size(), boost::hash_range(v.begin(), v.end()) };
+            static_guards_[bind_col_] = g;
+        }
+        else
+            static_guards_.erase(bind_col_);
+#endif
     }
 
     void operator()(const std::tm& v)
@@ -270,11 +374,34 @@ public:
 
     void operator()(std::istream* v)
     {
-        // TODO Fix me
-        std::ostringstream ss;
-        ss << v->rdbuf();
-        std::string tmp = ss.str();
-        check_bind(sqlite3_bind_text(st_, bind_col_, tmp.c_str(), int(tmp.size()), SQLITE_TRANSIENT));
+        // Stream is read by chunks into buffer owned by statement and bound as blob without one more copy.
+        // Size of seekable streams is known in advance, so buffer is allocated only once. Values that
+        // should not be held in memory are bound as zeroblob and written through connection::open_blob_impl.
+        blobs_.push_back(std::vector<char>());
+        std::vector<char>& blob = blobs_.back();
+
+        std::streampos pos = v->tellg();
+        if (pos != std::streampos(-1))
+        {
+            if (v->seekg(0, std::ios::end))
+                blob.reserve(static_cast<std::size_t>(v->tellg() - pos));
+
+            v->clear();
+            v->seekg(pos);
+        }
+
+        char chunk[16384];
+        do
+        {
+            v->read(chunk, sizeof(chunk));
+            blob.insert(blob.end(), chunk, chunk + v->gcount());
+        } while(*v);
+
+        if (blob.size() > static_cast<std::size_t>((std::numeric_limits<int>::max)()))
+            throw edba_error("sqlite3:blob is too big");
+
+        // Null pointer would bind NULL instead of empty blob
+        check_bind(sqlite3_bind_blob(st_, bind_col_, blob.empty() ? "" : &blob[0], int(blob.size()), SQLITE_STATIC));
     }
 
     // backend::statement implementation
@@ -292,6 +419,7 @@ public:
     virtual backend::result_ptr query_impl()
     {
         reset_stat();
+        check_static_bindings();
         reset_ = false;
         return backend::result_ptr(new result(st_,conn_));
     }
@@ -299,6 +427,7 @@ public:
     virtual void exec_impl()
     {
         reset_stat();
+        check_static_bindings();
         reset_ = false;
         int r = sqlite3_step(st_);
         if(r!=SQLITE_DONE) {
@@ -315,7 +444,53 @@ public:
         return sqlite3_changes(conn_);
     }
 
+    virtual unsigned long long exec_many_impl(const backend::bind_rows& rows)
+    {
+        // In autocommit mode each row would be committed (and synced to disk) separately,
+        // so wrap the whole batch in a single transaction when user did not start one.
+        if (!sqlite3_get_autocommit(conn_))
+            return backend::statement::exec_many_impl(rows);
+
+        check_exec(sqlite3_exec(conn_, "BEGIN", 0, 0, 0));
+
+        unsigned long long affected_total = 0;
+        try
+        {
+            affected_total = backend::statement::exec_many_impl(rows);
+        }
+        catch(...)
+        {
+            reset_stat();
+            if (!sqlite3_get_autocommit(conn_))
+                sqlite3_exec(conn_, "ROLLBACK", 0, 0, 0);
+            throw;
+        }
+
+        reset_stat();
+        check_exec(sqlite3_exec(conn_, "COMMIT", 0, 0, 0));
+        return affected_total;
+    }
+
 private:
+    // Strings bound with static_bind are not copied by SQLite, so in debug builds their hashes are checked
+    // before execution to catch storage that was modified or released by caller
+    void check_static_bindings()
+    {
+#ifndef NDEBUG
+        for(std::map<int, static_guard>::const_iterator it = static_guards_.begin(); it != static_guards_.end(); ++it)
+        {
+            const static_guard& g = it->second;
+            assert(boost::hash_range(g.data_, g.data_ + g.size_) == g.hash_ && "string bound with static_bind was released before execution");
+        }
+#endif
+    }
+
+    void check_exec(int v)
+    {
+        if(v!=SQLITE_OK) {
+            throw edba_error(std::string("sqlite3:") + sqlite3_errmsg(conn_));
+        }
+    }
     void check_bind(int v)
     {
         if(v==SQLITE_RANGE) {
@@ -330,12 +505,79 @@ private:
     std::string orig_sql_;
     bool reset_;
     int bind_col_;
+    std::list< std::vector<char> > blobs_;  // Data of bound streams, valid until bindings are reset
+
+#ifndef NDEBUG
+    struct static_guard
+    {
+        const char* data_;
+        std::size_t size_;
+        std::size_t hash_;
+    };
+
+    std::map<int, static_guard> static_guards_;  // Strings bound with static_bind by column
+#endif
+};
+
+// Blob opened for incremental I/O. SQLite blobs can`t be larger than 2GB, so offsets fit into int.
+class blob : public backend::blob_iface
+{
+public:
+    blob(sqlite3* conn, sqlite3_blob* b) : conn_(conn), blob_(b)
+    {
+    }
+    ~blob()
+    {
+        sqlite3_blob_close(blob_);
+    }
+
+    virtual boost::uint64_t size()
+    {
+        return static_cast<boost::uint64_t>(sqlite3_blob_bytes(blob_));
+    }
+
+    virtual std::size_t read(boost::uint64_t offset, char* buf, std::size_t n)
+    {
+        boost::uint64_t total = size();
+        if (offset >= total)
+            return 0;
+
+        n = static_cast<std::size_t>((std::min)(boost::uint64_t(n), total - offset));
+        check(sqlite3_blob_read(blob_, buf, int(n), int(offset)));
+        return n;
+    }
+
+    virtual void write(boost::uint64_t offset, const char* buf, std::size_t n)
+    {
+        boost::uint64_t total = size();
+        if (offset > total || n > total - offset)
+            throw edba_error("sqlite3:data doesn`t fit into blob");
+
+        check(sqlite3_blob_write(blob_, buf, int(n), int(offset)));
+    }
+
+private:
+    void check(int v)
+    {
+        if(v!=SQLITE_OK) {
+            throw edba_error(std::string("sqlite3:") + sqlite3_errmsg(conn_));
+        }
+    }
+
+    sqlite3 *conn_;
+    sqlite3_blob *blob_;
 };
 
 class connection : public backend::connection {
 public:
     connection(const conn_info& ci, session_monitor* si) : backend::connection(ci, si), conn_(0)
     {
+        // Milliseconds to wait for locks held by other connections, statements and backup fail with
+        // "database is locked" after that
+        busy_timeout_ = ci.get("@sqlite_busy_timeout", 0);
+        if(busy_timeout_ < 0)
+            throw edba_error("sqlite3:@sqlite_busy_timeout should be non negative number");
+
         std::string dbname = ci.get_copy("db");
         if(dbname.empty()) {
             throw edba_error("sqlite3:database file (db propery) not specified");
@@ -355,6 +597,13 @@ public:
                 " 'create' (default), 'readwrite' or 'readonly' values");
         }
 
+        // Connection is never used by several threads at once when it is owned by session or session_pool,
+        // so SQLite mutexes can be turned off
+        if(on_off_property(ci, "@sqlite_nomutex"))
+            flags |= SQLITE_OPEN_NOMUTEX;
+
+        bool wal = on_off_property(ci, "@sqlite_wal");
+
         std::string vfs = ci.get_copy("vfs");
         char const *cvfs = vfs.empty() ? (char const *)(0) : vfs.c_str();
 
@@ -368,6 +617,25 @@ public:
             conn_ = 0;
             throw edba_error("sqlite3:Failed to open connection:" + error_message);
         }
+
+        if(busy_timeout_ > 0)
+            sqlite3_busy_timeout(conn_, busy_timeout_);
+
+        // In WAL mode readers don`t block writer and writer doesn`t block readers. Journal mode is persistent,
+        // so read-only connections just use mode set by writer.
+        if(wal && (flags & SQLITE_OPEN_READWRITE))
+        {
+            try
+            {
+                fast_exec("pragma journal_mode=wal");
+            }
+            catch(...)
+            {
+                sqlite3_close(conn_);
+                conn_ = 0;
+                throw;
+            }
+        }
     }
     virtual ~connection()
     {
@@ -404,6 +672,30 @@ public:
             fast_exec(tmp.c_str());
         }
     }
+    virtual void backup_to_impl(const string_ref& path, int pages_per_step, const backup_progress& progress)
+    {
+        database file(path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+        copy_database(file.db_, conn_, pages_per_step, busy_timeout_, progress);
+    }
+
+    virtual void restore_from_impl(const string_ref& path, int pages_per_step, const backup_progress& progress)
+    {
+        database file(path, SQLITE_OPEN_READONLY);
+        copy_database(conn_, file.db_, pages_per_step, busy_timeout_, progress);
+    }
+
+    virtual backend::blob_ptr open_blob_impl(const string_ref& table, const string_ref& column, long long rowid, bool writable)
+    {
+        std::string t(table.begin(), table.end());
+        std::string c(column.begin(), column.end());
+
+        sqlite3_blob* b = 0;
+        if(sqlite3_blob_open(conn_, "main", t.c_str(), c.c_str(), static_cast<sqlite3_int64>(rowid), writable ? 1 : 0, &b) != SQLITE_OK)
+            throw edba_error(std::string("sqlite3:") + sqlite3_errmsg(conn_));
+
+        return backend::blob_ptr(new blob(conn_, b));
+    }
+
     virtual std::string escape(const string_ref& str)
     {
         std::string result;
@@ -446,7 +738,76 @@ private:
         }
     }
 
+    // Database file opened for backup, closed when backup is finished
+    struct database
+    {
+        database(const string_ref& path, int flags) : db_(0)
+        {
+            std::string name(path.begin(), path.end());
+            if(sqlite3_open_v2(name.c_str(), &db_, flags, 0) != SQLITE_OK) {
+                std::string error_message = db_ ? sqlite3_errmsg(db_) : "failed to create db object";
+                sqlite3_close(db_);
+                throw edba_error("sqlite3:Failed to open " + name + ":" + error_message);
+            }
+        }
+
+        ~database()
+        {
+            sqlite3_close(db_);
+        }
+
+        sqlite3* db_;
+    };
+
+    // Copy main database of src into dest using online backup API. Steps that fail because database
+    // is locked by other connection are retried until they wait for busy_timeout milliseconds in a row.
+    static void copy_database(sqlite3* dest, sqlite3* src, int pages_per_step, int busy_timeout, const backup_progress& progress)
+    {
+        sqlite3_backup* backup = sqlite3_backup_init(dest, "main", src, "main");
+        if(!backup)
+            throw edba_error(std::string("sqlite3:") + sqlite3_errmsg(dest));
+
+        int r;
+        int waited = 0;
+        try
+        {
+            do
+            {
+                r = sqlite3_backup_step(backup, pages_per_step);
+
+                if(SQLITE_BUSY == r || SQLITE_LOCKED == r)
+                {
+                    if(waited >= busy_timeout)
+                        break;
+
+                    int ms = (std::min)(100, busy_timeout - waited);
+                    sqlite3_sleep(ms);
+                    waited += ms;
+                }
+                else
+                {
+                    waited = 0;
+                    if(progress && (SQLITE_OK == r || SQLITE_DONE == r))
+                        progress(sqlite3_backup_remaining(backup), sqlite3_backup_pagecount(backup));
+                }
+            } while(SQLITE_OK == r || SQLITE_BUSY == r || SQLITE_LOCKED == r);
+        }
+        catch(...)
+        {
+            sqlite3_backup_finish(backup);
+            throw;
+        }
+
+        // Locking errors are not reported by sqlite3_backup_finish
+        int finished = sqlite3_backup_finish(backup);
+        if(SQLITE_BUSY == r || SQLITE_LOCKED == r)
+            throw edba_error("sqlite3:backup failed:database is locked");
+        if(finished != SQLITE_OK)
+            throw edba_error(std::string("sqlite3:backup failed:") + sqlite3_errmsg(dest));
+    }
+
     sqlite3 *conn_;
+    int busy_timeout_;
 };
 
 }}}} // edba, backend, sqlite3, anonymous
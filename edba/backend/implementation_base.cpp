@@ -1,12 +1,13 @@
 #include <edba/backend/implementation_base.hpp>
 #include <edba/session_monitor.hpp>
 #include <edba/conn_info.hpp>
+#include <edba/query_handle.hpp>
 
 #include <edba/detail/utils.hpp>
 
 #include <boost/algorithm/string/predicate.hpp>
-#include <boost/range/algorithm/equal_range.hpp>
-#include <boost/range/algorithm/sort.hpp>
+#include <boost/range/algorithm/equal.hpp>
+#include <boost/range/algorithm/find.hpp>
 #include <boost/typeof/typeof.hpp>
 #include <boost/timer.hpp>
 
@@ -18,6 +19,9 @@ namespace edba { namespace backend {
 EDBA_ADD_INTRUSIVE_PTR_SUPPORT_FOR_TYPE_IMPL(result_iface)
 EDBA_ADD_INTRUSIVE_PTR_SUPPORT_FOR_TYPE_IMPL(statement_iface)
 EDBA_ADD_INTRUSIVE_PTR_SUPPORT_FOR_TYPE_IMPL(connection_iface)
+EDBA_ADD_INTRUSIVE_PTR_SUPPORT_FOR_TYPE_IMPL(pipeline_iface)
+EDBA_ADD_INTRUSIVE_PTR_SUPPORT_FOR_TYPE_IMPL(bulk_writer_iface)
+EDBA_ADD_INTRUSIVE_PTR_SUPPORT_FOR_TYPE_IMPL(blob_iface)
 
 //////////////
 //statement
@@ -25,9 +29,21 @@ EDBA_ADD_INTRUSIVE_PTR_SUPPORT_FOR_TYPE_IMPL(connection_iface)
 
 statement::statement(session_stat* sess_stat)
   : stat_(sess_stat)
+  , result_mode_(buffered_result)
+  , bind_mode_(copied_bind)
 {
 }
 
+void statement::set_result_mode(result_mode m)
+{
+    result_mode_ = m;
+}
+
+void statement::set_bind_mode(bind_mode m)
+{
+    bind_mode_ = m;
+}
+
 void statement::bind(int col, const bind_types_variant& val)
 {
     bind_impl(col, val);
@@ -40,6 +56,64 @@ void statement::bind(const string_ref& name, const bind_types_variant& val)
     stat_.bind(name, val);
 }
 
+void statement::bind_null(int col)
+{
+    bind_null_impl(col);
+    if (stat_.parent_stat()->user_monitor())
+        stat_.bind(col, bind_types_variant(null));
+}
+
+void statement::bind_int64(int col, long long v)
+{
+    bind_int64_impl(col, v);
+    if (stat_.parent_stat()->user_monitor())
+        stat_.bind(col, bind_types_variant(v));
+}
+
+void statement::bind_double(int col, double v)
+{
+    bind_double_impl(col, v);
+    if (stat_.parent_stat()->user_monitor())
+        stat_.bind(col, bind_types_variant(v));
+}
+
+void statement::bind_text(int col, const string_ref& v)
+{
+    bind_text_impl(col, v);
+    if (stat_.parent_stat()->user_monitor())
+        stat_.bind(col, bind_types_variant(v));
+}
+
+void statement::bind_zeroblob(int col, boost::uint64_t size)
+{
+    bind_zeroblob_impl(col, size);
+}
+
+void statement::bind_null_impl(int col)
+{
+    bind_impl(col, bind_types_variant(null));
+}
+
+void statement::bind_int64_impl(int col, long long v)
+{
+    bind_impl(col, bind_types_variant(v));
+}
+
+void statement::bind_double_impl(int col, double v)
+{
+    bind_impl(col, bind_types_variant(v));
+}
+
+void statement::bind_text_impl(int col, const string_ref& v)
+{
+    bind_impl(col, bind_types_variant(v));
+}
+
+void statement::bind_zeroblob_impl(int, boost::uint64_t)
+{
+    throw not_supported_by_backend("edba::zeroblob is not supported by backend");
+}
+
 void statement::reset_bindings()
 {
     reset_bindings_impl();
@@ -62,25 +136,130 @@ void statement::run_exec()
     exec_impl();
 }
 
+unsigned long long statement::run_exec_many(const bind_rows& rows)
+{
+    unsigned long long affected = 0;
+    {
+        statement_stat::measure_batch m(&stat_, &patched_query(), rows.rows(), &affected);
+        affected = exec_many_impl(rows);
+    }
+    reset_bindings();
+    return affected;
+}
+
+unsigned long long statement::exec_many_impl(const bind_rows& rows)
+{
+    unsigned long long affected_total = 0;
+    for(std::size_t r = 0; r < rows.rows(); ++r)
+    {
+        bind_row(rows, r);
+        exec_impl();
+        affected_total += affected();
+    }
+    return affected_total;
+}
+
+void statement::bind_row(const bind_rows& rows, std::size_t r)
+{
+    reset_bindings_impl();
+    for(const bind_rows::value* v = rows.row_begin(r); v != rows.row_end(r); ++v)
+    {
+        if (v->col_)
+            bind_impl(v->col_, v->value_);
+        else
+            bind_impl(v->name_, v->value_);
+    }
+}
+
 //////////////
 //connection
 //////////////
 
+namespace {
+    // Memoized conditionals are dropped all at once when there are too many of them
+    const std::size_t max_memoized_conditionals = 1024;
+}
+
+void connection::init_conditionals()
+{
+    // Backend is fully constructed only after connection constructor, so engine and version 
+    // are captured on first use
+    if (!conditionals_ready_)
+    {
+        cond_engine_ = engine();
+        version(cond_ver_major_, cond_ver_minor_);
+        conditionals_ready_ = 1;
+    }
+}
+
+connection::resolved_conditional* connection::find_conditional(conditionals_map& m, const string_ref& src, boost::uint64_t h)
+{
+    BOOST_AUTO(found, m.equal_range(h));
+    for(; found.first != found.second; ++found.first)
+    {
+        if (boost::equal(found.first->second.source_, src))
+            return &found.first->second;
+    }
+
+    return 0;
+}
+
+connection::resolved_conditional& connection::add_conditional(conditionals_map& m, const string_ref& src, boost::uint64_t h)
+{
+    if (m.size() >= max_memoized_conditionals)
+        m.clear();
+
+    BOOST_AUTO(it, m.insert(std::make_pair(h, resolved_conditional())));
+    it->second.source_.assign(src.begin(), src.end());
+    it->second.begin_ = it->second.end_ = 0;
+    return it->second;
+}
+
 string_ref connection::select_statement(const string_ref& _q)
 {
-    string_ref q;
+    if(!expand_conditionals_)
+        return _q;
 
-    if(expand_conditionals_)
+    // Non conditional statements are just trimmed, there is nothing to memoize
+    string_ref q = trim(_q);
+    if (q.empty() || '~' != q.front())
+        return q;
+
+    init_conditionals();
+
+    boost::uint64_t h = hash_query(q);
+    resolved_conditional* rc = find_conditional(statements_, q, h);
+    if (!rc)
     {
-        int major;
-        int minor;
-        version(major, minor);
-        q = ::edba::select_statement(_q, engine(), major, minor);
+        string_ref selected = ::edba::select_statement(q, cond_engine_, cond_ver_major_, cond_ver_minor_);
+        rc = &add_conditional(statements_, q, h);
+        if (!selected.empty())
+        {
+            rc->begin_ = selected.begin() - q.begin();
+            rc->end_ = selected.end() - q.begin();
+        }
+    }
+
+    return string_ref(q.begin() + rc->begin_, q.begin() + rc->end_);
+}
+
+std::string connection::select_statements_in_batch(const string_ref& q)
+{
+    if (boost::find(q, '~') == q.end())
+        return std::string(q.begin(), q.end());
+
+    init_conditionals();
+
+    boost::uint64_t h = hash_query(q);
+    resolved_conditional* rc = find_conditional(batches_, q, h);
+    if (!rc)
+    {
+        std::string batch = ::edba::select_statements_in_batch(q, cond_engine_, cond_ver_major_, cond_ver_minor_);
+        rc = &add_conditional(batches_, q, h);
+        rc->batch_.swap(batch);
     }
-    else
-        q = _q;
 
-    return q;
+    return rc->batch_;
 }
 
 statement_ptr connection::prepare_statement(const string_ref& _q)
@@ -90,25 +269,87 @@ statement_ptr connection::prepare_statement(const string_ref& _q)
     if (q.empty())
         return statement_ptr();
 
-    BOOST_AUTO(found, (boost::equal_range(cache_, q, string_ref_less())));
-    if (boost::empty(found))
+    return prepare_cached_statement(q, hash_query(q));
+}
+
+statement_ptr connection::prepare_statement(const query_handle& _q)
+{
+    if (_q.slot() < query_slots_.size() && query_slots_[_q.slot()])
     {
-        statement_ptr st = prepare_statement_impl(q);
-        cache_.resize(cache_.size() + 1);
-        cache_.back().first.assign(q.begin(), q.end());
-        cache_.back().second = st;
-        boost::sort(cache_, string_ref_less());
-        return st;
+        ++cache_stats_.hits_;
+        query_slots_[_q.slot()]->reset_bindings();
+        query_slots_[_q.slot()]->set_result_mode(buffered_result);
+        query_slots_[_q.slot()]->set_bind_mode(copied_bind);
+        return query_slots_[_q.slot()];
     }
-    else
+
+    string_ref q = select_statement(_q.text());
+
+    if (q.empty())
+        return statement_ptr();
+
+    // Precomputed hash is valid only if conditionals expansion left query text untouched
+    boost::uint64_t h = (q.begin() == _q.text().begin() && q.end() == _q.text().end()) ? _q.hash() : hash_query(q);
+    statement_ptr st = prepare_cached_statement(q, h);
+
+    if (_q.slot() >= query_slots_.size())
+        query_slots_.resize(_q.slot() + 1);
+
+    query_slots_[_q.slot()] = st;
+    return st;
+}
+
+statement_ptr connection::prepare_cached_statement(const string_ref& q, boost::uint64_t h)
+{
+    BOOST_AUTO(found, cache_index_.equal_range(h));
+    for(; found.first != found.second; ++found.first)
+    {
+        stmt_list::iterator it = found.first->second;
+        if (boost::equal(it->query_, q))
+        {
+            ++cache_stats_.hits_;
+            cache_.splice(cache_.begin(), cache_, it);
+            it->stmt_->reset_bindings();
+            it->stmt_->set_result_mode(buffered_result);
+            it->stmt_->set_bind_mode(copied_bind);
+            return it->stmt_;
+        }
+    }
+
+    statement_ptr st = prepare_statement_impl(q);
+    ++cache_stats_.misses_;
+
+    // Dropping cache reference lets backend finalize statement as soon as nobody else holds it
+    if (cache_stats_.capacity_ && cache_.size() >= cache_stats_.capacity_)
     {
-        found.first->second->reset_bindings();
-        return found.first->second;
+        BOOST_AUTO(lru, cache_index_.equal_range(cache_.back().hash_));
+        for(; lru.first != lru.second; ++lru.first)
+        {
+            if (lru.first->second == --cache_.end())
+            {
+                cache_index_.erase(lru.first);
+                break;
+            }
+        }
+        cache_.pop_back();
+        ++cache_stats_.evictions_;
     }
+
+    cache_.push_front(cached_statement());
+    cache_.front().query_.assign(q.begin(), q.end());
+    cache_.front().hash_ = h;
+    cache_.front().stmt_ = st;
+    cache_index_.insert(std::make_pair(h, cache_.begin()));
+
+    return st;
 }
 
 void connection::before_destroy()
 {
+    statements_.clear();
+    batches_.clear();
+    query_slots_.clear();
+    cache_index_.clear();
     cache_.clear();
 }
 
@@ -121,12 +362,7 @@ statement_ptr connection::create_statement(const string_ref& _q)
 void connection::exec_batch(const string_ref& _q)
 {
     if(expand_conditionals_)
-    {
-        int major;
-        int minor;
-        version(major, minor);
-        exec_batch_impl(select_statements_in_batch(_q, engine(), major, minor));
-    }
+        exec_batch_impl(select_statements_in_batch(_q));
     else
         exec_batch_impl(_q);
 }
@@ -177,9 +413,79 @@ const conn_info& connection::connection_info() const
     return info_;
 }
 
+statement_cache_stats connection::cache_stats() const
+{
+    statement_cache_stats stats = cache_stats_;
+    stats.size_ = cache_.size();
+    return stats;
+}
+
+pipeline_ptr connection::create_pipeline()
+{
+    return create_pipeline_impl();
+}
+
+pipeline_ptr connection::create_pipeline_impl()
+{
+    throw not_supported_by_backend("edba::pipeline is not supported by " + backend() + " backend");
+}
+
+bulk_writer_ptr connection::create_bulk_writer(const string_ref& table, const string_ref& columns, bulk_format format)
+{
+    return create_bulk_writer_impl(table, columns, format);
+}
+
+bulk_writer_ptr connection::create_bulk_writer_impl(const string_ref&, const string_ref&, bulk_format)
+{
+    throw not_supported_by_backend("edba::bulk_writer is not supported by " + backend() + " backend");
+}
+
+unsigned long long connection::copy_to(const string_ref& q, bulk_format format, const copy_sink& sink)
+{
+    return copy_to_impl(q, format, sink);
+}
+
+unsigned long long connection::copy_to_impl(const string_ref&, bulk_format, const copy_sink&)
+{
+    throw not_supported_by_backend("edba::session::copy_to is not supported by " + backend() + " backend");
+}
+
+void connection::backup_to(const string_ref& path, int pages_per_step, const backup_progress& progress)
+{
+    backup_to_impl(path, pages_per_step, progress);
+}
+
+void connection::backup_to_impl(const string_ref&, int, const backup_progress&)
+{
+    throw not_supported_by_backend("edba::session::backup_to is not supported by " + backend() + " backend");
+}
+
+void connection::restore_from(const string_ref& path, int pages_per_step, const backup_progress& progress)
+{
+    restore_from_impl(path, pages_per_step, progress);
+}
+
+void connection::restore_from_impl(const string_ref&, int, const backup_progress&)
+{
+    throw not_supported_by_backend("edba::session::restore_from is not supported by " + backend() + " backend");
+}
+
+blob_ptr connection::open_blob(const string_ref& table, const string_ref& column, long long rowid, bool writable)
+{
+    return open_blob_impl(table, column, rowid, writable);
+}
+
+blob_ptr connection::open_blob_impl(const string_ref&, const string_ref&, long long, bool)
+{
+    throw not_supported_by_backend("edba::session::open_blob is not supported by " + backend() + " backend");
+}
+
 connection::connection(conn_info const &info, session_monitor* sm)
   : info_(info)
   , stat_(sm)
+  , cond_ver_major_(0)
+  , cond_ver_minor_(0)
+  , conditionals_ready_(0)
 {
     const std::locale& loc = std::locale::classic();
     string_ref exp_cond = info.get("@expand_conditionals", "on");
@@ -190,6 +496,11 @@ connection::connection(conn_info const &info, session_monitor* sm)
     else
         throw edba_error("edba::backend::connection: @expand_conditionals should be either 'on' or 'off'");
 
+    int cache_size = info.get("@stmt_cache_size", 256);
+    if (cache_size < 0)
+        throw edba_error("edba::backend::connection: @stmt_cache_size should be non negative number");
+
+    cache_stats_.capacity_ = cache_size;
 }
 
 }}
@@ -5,14 +5,35 @@
 #include <edba/backend/statistics.hpp>
 #include <edba/conn_info.hpp>
 
+#include <boost/unordered_map.hpp>
+
+#include <list>
 #include <vector>
-#include <utility>
 #include <string>
 
 namespace edba { namespace backend {
 
 class result : public result_iface 
 {
+public:
+    ///
+    /// Default implementation of typed fetch functions, forward call to fetch(int, const fetch_types_variant&).
+    /// Backends may override them to read values directly.
+    ///
+    virtual bool fetch_int64(int col, long long& v)
+    {
+        return fetch(col, fetch_types_variant(&v));
+    }
+
+    virtual bool fetch_double(int col, double& v)
+    {
+        return fetch(col, fetch_types_variant(&v));
+    }
+
+    virtual bool fetch_text(int col, std::string& v)
+    {
+        return fetch(col, fetch_types_variant(&v));
+    }
 };
 
 class EDBA_API statement : public statement_iface
@@ -32,6 +53,22 @@ protected:
     virtual void bind_impl(int col, bind_types_variant const& v) = 0;
     virtual void bind_impl(const string_ref& name, bind_types_variant const& v) = 0; 
 
+    ///
+    /// Bind value of the specific type to column \a col (starting from 1).
+    ///
+    /// Default implementation forwards call to bind_impl(int, bind_types_variant const&), 
+    /// backends may override them to avoid variant dispatching.
+    ///
+    virtual void bind_null_impl(int col);
+    virtual void bind_int64_impl(int col, long long v);
+    virtual void bind_double_impl(int col, double v);
+    virtual void bind_text_impl(int col, const string_ref& v);
+
+    ///
+    /// Bind blob of \a size zero bytes to column \a col (starting from 1). Default implementation throws not_supported_by_backend.
+    ///
+    virtual void bind_zeroblob_impl(int col, boost::uint64_t size);
+
     ///
     /// Reset all bindings
     ///
@@ -47,6 +84,19 @@ protected:
     ///
     virtual void exec_impl() = 0;
 
+    ///
+    /// Execute a statement for each row in \a rows and return total number of affected rows.
+    ///
+    /// Default implementation binds and executes rows one by one, backends should override it 
+    /// to use native bulk execution.
+    ///
+    virtual unsigned long long exec_many_impl(const bind_rows& rows);
+
+    ///
+    /// Reset bindings and bind all values from row \a r
+    ///
+    void bind_row(const bind_rows& rows, std::size_t r);
+
 public:
     ///
     /// Bind value to column \a col (starting from 1).
@@ -62,11 +112,32 @@ public:
     ///
     void bind(const string_ref& name, const bind_types_variant& val);
 
+    ///
+    /// Bind value of the specific type to column \a col (starting from 1).
+    ///
+    /// Dispatch call to suitable implementation
+    ///
+    void bind_null(int col);
+    void bind_int64(int col, long long v);
+    void bind_double(int col, double v);
+    void bind_text(int col, const string_ref& v);
+    void bind_zeroblob(int col, boost::uint64_t size);
+
     ///
     /// Reset all bindings to initial state
     ///
     void reset_bindings();
 
+    ///
+    /// Set how results of subsequent queries are transferred, backends check result_mode_ in query_impl
+    ///
+    void set_result_mode(result_mode m);
+
+    ///
+    /// Set how strings bound later are passed to database client library, backends check bind_mode_ in bind_impl
+    ///
+    void set_bind_mode(bind_mode m);
+
     ///
     /// Return SQL Query result, MAY throw edba_error if the statement is not a query
     ///
@@ -77,8 +148,15 @@ public:
     ///
     void run_exec();
 
+    ///
+    /// Execute a statement once for each row of parameters in \a rows. Return total number of affected rows.
+    ///
+    unsigned long long run_exec_many(const bind_rows& rows);
+
 protected:    
     statement_stat stat_; 
+    result_mode result_mode_;
+    bind_mode bind_mode_;
 };
 
 class EDBA_API connection : public connection_iface 
@@ -118,6 +196,36 @@ protected:
     ///
     virtual void rollback_impl() = 0;
 
+    ///
+    /// Create pipeline. Default implementation throws not_supported_by_backend.
+    ///
+    virtual pipeline_ptr create_pipeline_impl();
+
+    ///
+    /// Create bulk writer. Default implementation throws not_supported_by_backend.
+    ///
+    virtual bulk_writer_ptr create_bulk_writer_impl(const string_ref& table, const string_ref& columns, bulk_format format);
+
+    ///
+    /// Export query result. Default implementation throws not_supported_by_backend.
+    ///
+    virtual unsigned long long copy_to_impl(const string_ref& q, bulk_format format, const copy_sink& sink);
+
+    ///
+    /// Copy database into file. Default implementation throws not_supported_by_backend.
+    ///
+    virtual void backup_to_impl(const string_ref& path, int pages_per_step, const backup_progress& progress);
+
+    ///
+    /// Replace database with copy of file. Default implementation throws not_supported_by_backend.
+    ///
+    virtual void restore_from_impl(const string_ref& path, int pages_per_step, const backup_progress& progress);
+
+    ///
+    /// Open blob for incremental access. Default implementation throws not_supported_by_backend.
+    ///
+    virtual blob_ptr open_blob_impl(const string_ref& table, const string_ref& column, long long rowid, bool writable);
+
 public:
     connection(conn_info const &info, session_monitor* sm);
 
@@ -128,6 +236,12 @@ public:
     /// 
     statement_ptr prepare_statement(const string_ref& q);
 
+    ///
+    /// Get statement from slot reserved for query \a q. If slot is empty then prepare statement
+    /// with precomputed query hash and keep it in slot until connection is closed.
+    ///
+    statement_ptr prepare_statement(const query_handle& q);
+
     ///
     /// Create a (unprepared) statement \a q. May throw if had failed.
     /// Should never return null value.
@@ -157,19 +271,65 @@ public:
 
     double total_execution_time() const;
     const conn_info& connection_info() const;
+    statement_cache_stats cache_stats() const;
+    pipeline_ptr create_pipeline();
+    bulk_writer_ptr create_bulk_writer(const string_ref& table, const string_ref& columns, bulk_format format);
+    unsigned long long copy_to(const string_ref& q, bulk_format format, const copy_sink& sink);
+    void backup_to(const string_ref& path, int pages_per_step, const backup_progress& progress);
+    void restore_from(const string_ref& path, int pages_per_step, const backup_progress& progress);
+    blob_ptr open_blob(const string_ref& table, const string_ref& column, long long rowid, bool writable);
 
 protected:
-    typedef std::vector< std::pair<std::string, statement_ptr > > stmt_map;
+    struct cached_statement
+    {
+        std::string query_;
+        boost::uint64_t hash_;
+        statement_ptr stmt_;
+    };
+
+    struct identity_hash
+    {
+        std::size_t operator()(boost::uint64_t h) const { return static_cast<std::size_t>(h); }
+    };
+
+    // Most recently used statements are kept at the front of the list
+    typedef std::list<cached_statement> stmt_list;
+    typedef boost::unordered_multimap<boost::uint64_t, stmt_list::iterator, identity_hash> stmt_index;
+
+    // Resolution of conditional statement or batch, begin_ and end_ are offsets in source text
+    struct resolved_conditional
+    {
+        std::string source_;
+        std::size_t begin_;
+        std::size_t end_;
+        std::string batch_;
+    };
+
+    typedef boost::unordered_multimap<boost::uint64_t, resolved_conditional, identity_hash> conditionals_map;
 
     void before_destroy();
+    void init_conditionals();
+    resolved_conditional* find_conditional(conditionals_map& m, const string_ref& src, boost::uint64_t h);
+    resolved_conditional& add_conditional(conditionals_map& m, const string_ref& src, boost::uint64_t h);
     string_ref select_statement(const string_ref& _q);
+    std::string select_statements_in_batch(const string_ref& _q);
+    statement_ptr prepare_cached_statement(const string_ref& q, boost::uint64_t h);
 
     conn_info info_;
     session_stat stat_;
-    stmt_map cache_;                              // Statement cache
+    stmt_list cache_;                             // Statement cache in LRU order
+    stmt_index cache_index_;                      // Statement cache index by query hash
+    statement_cache_stats cache_stats_;           // Statement cache counters
+    std::vector<statement_ptr> query_slots_;      // Statements prepared for edba::query handles
+    conditionals_map statements_;                 // Memoized conditional statements
+    conditionals_map batches_;                    // Memoized conditional batches
+    std::string cond_engine_;                     // Engine name used for conditionals expansion
+    int cond_ver_major_;                          // Engine version used for conditionals expansion
+    int cond_ver_minor_;
     boost::any specific_data_;                    // Connection specific data
     unsigned expand_conditionals_ : 1;            // If true then process query as list of backend specific queries
-    unsigned reserved_ : 30;
+    unsigned conditionals_ready_ : 1;             // If true then cond_engine_ and version are already known
+    unsigned reserved_ : 29;
 };
 
 }} // namespace edba, backend
@@ -7,9 +7,123 @@
 #include <boost/any.hpp>
 
 #include <string>
+#include <vector>
+#include <deque>
 
 namespace edba { namespace backend {
 
+///
+/// Parameters for bulk execution of a statement collected row by row. Strings are copied, 
+/// so values remain valid after the source objects have gone.
+///
+class bind_rows
+{
+public:
+    struct value
+    {
+        int col_;                   ///< Placeholder index starting from 1, 0 if bound by name
+        string_ref name_;           ///< Placeholder name if bound by name
+        bind_types_variant value_;
+    };
+
+    bind_rows() : has_names_(false), has_streams_(false)
+    {
+        row_ends_.push_back(0);
+    }
+
+    void add(int col, const bind_types_variant& v)
+    {
+        values_.push_back(value());
+        values_.back().col_ = col;
+        values_.back().value_ = own(v);
+    }
+
+    void add(const string_ref& name, const bind_types_variant& v)
+    {
+        strings_.push_back(std::string(name.begin(), name.end()));
+        values_.push_back(value());
+        values_.back().col_ = 0;
+        values_.back().name_ = strings_.back();
+        values_.back().value_ = own(v);
+        has_names_ = true;
+    }
+
+    void end_row()
+    {
+        row_ends_.push_back(values_.size());
+    }
+
+    /// Return the number of complete rows
+    std::size_t rows() const
+    {
+        return row_ends_.size() - 1;
+    }
+
+    /// Return range of values bound for row \a r starting from 0
+    const value* row_begin(std::size_t r) const
+    {
+        return values_.empty() ? 0 : &values_.front() + row_ends_[r];
+    }
+
+    const value* row_end(std::size_t r) const
+    {
+        return values_.empty() ? 0 : &values_.front() + row_ends_[r + 1];
+    }
+
+    /// Return true if each row binds exactly columns 1..cols in order. Native bulk implementations
+    /// usually require that, otherwise they should fallback to row by row execution.
+    bool dense(int cols) const
+    {
+        if (has_names_)
+            return false;
+
+        for(std::size_t r = 0; r < rows(); ++r)
+        {
+            if (row_ends_[r + 1] - row_ends_[r] != std::size_t(cols))
+                return false;
+
+            for(int c = 0; c < cols; ++c)
+                if (values_[row_ends_[r] + c].col_ != c + 1)
+                    return false;
+        }
+
+        return true;
+    }
+
+    /// Return value bound to column \a col (starting from 1) in row \a r, valid only for dense rows
+    const bind_types_variant& at(std::size_t r, int col) const
+    {
+        return values_[row_ends_[r] + col - 1].value_;
+    }
+
+    /// Return true if any of rows contains std::istream* value
+    bool has_streams() const
+    {
+        return has_streams_;
+    }
+
+private:
+    bind_types_variant own(const bind_types_variant& v)
+    {
+        if (const string_ref* s = boost::get<string_ref>(&v))
+        {
+            strings_.push_back(std::string(s->begin(), s->end()));
+            return bind_types_variant(string_ref(strings_.back()));
+        }
+
+        if (boost::get<std::istream*>(&v))
+            has_streams_ = true;
+
+        return v;
+    }
+
+    std::vector<value> values_;
+    std::vector<std::size_t> row_ends_;
+    std::deque<std::string> strings_;
+    bool has_names_;
+    bool has_streams_;
+};
+
 struct result_iface : ref_cnt
 {
 public:
@@ -44,6 +158,14 @@ public:
     ///
     virtual bool fetch(int col, const fetch_types_variant& v) = 0;
 
+    ///
+    /// Fetch value of the specific type from column \a col starting from 0 without constructing fetch_types_variant.
+    /// Same as fetch(int col, const fetch_types_variant& v) in all other respects.
+    ///
+    virtual bool fetch_int64(int col, long long& v) = 0;
+    virtual bool fetch_double(int col, double& v) = 0;
+    virtual bool fetch_text(int col, std::string& v) = 0;
+
     ///
     /// Return true if value is null at specified column
     ///
@@ -89,11 +211,38 @@ struct statement_iface : ref_cnt
     ///
     virtual void bind(const string_ref& name, const bind_types_variant& val) = 0;
 
+    ///
+    /// Bind value of the specific type to column \a col (starting from 1) without constructing bind_types_variant.
+    ///
+    virtual void bind_null(int col) = 0;
+    virtual void bind_int64(int col, long long v) = 0;
+    virtual void bind_double(int col, double v) = 0;
+    virtual void bind_text(int col, const string_ref& v) = 0;
+
+    ///
+    /// Bind blob of \a size zero bytes to column \a col (starting from 1), it is filled later through blob_iface.
+    /// MUST throw not_supported_by_backend() if it is not supported.
+    ///
+    virtual void bind_zeroblob(int col, boost::uint64_t size) = 0;
+
     ///
     /// Reset all bindings to initial state
     ///
     virtual void reset_bindings() = 0;
 
+    ///
+    /// Set how results of subsequent queries are transferred. Backends without streaming support
+    /// ignore streamed_result. While streamed result is not fully read or destroyed, the connection
+    /// can`t be used for other statements.
+    ///
+    virtual void set_result_mode(result_mode m) = 0;
+
+    ///
+    /// Set how strings bound later are passed to database client library. Backends without
+    /// zero-copy binding support ignore static_bind.
+    ///
+    virtual void set_bind_mode(bind_mode m) = 0;
+
     ///
     /// Return query that is scheduled for execution by backend after all possible transformations
     ///
@@ -109,6 +258,12 @@ struct statement_iface : ref_cnt
     ///
     virtual void run_exec() = 0;
 
+    ///
+    /// Execute a statement once for each row of parameters in \a rows. Return total number of affected rows.
+    /// Bindings are reset after execution.
+    ///
+    virtual unsigned long long run_exec_many(const bind_rows& rows) = 0;
+
     ///
     /// Fetch the last sequence generated for last inserted row. May use sequence as parameter
     /// if the database uses sequences, should ignore the parameter \a sequence if the last
@@ -128,6 +283,114 @@ struct statement_iface : ref_cnt
     virtual unsigned long long affected() = 0;
 };
 
+///
+/// Queue of statements which are sent to database together and whose results are collected afterwards
+///
+struct pipeline_iface : public ref_cnt
+{
+    virtual ~pipeline_iface() {}
+
+    ///
+    /// Queue execution of statement \a st with its current bindings. Return index of queued statement.
+    ///
+    virtual std::size_t exec(const statement_ptr& st) = 0;
+
+    ///
+    /// Queue query \a st with its current bindings. Return index of queued query.
+    ///
+    virtual std::size_t query(const statement_ptr& st) = 0;
+
+    ///
+    /// Send all queued statements and receive their results
+    ///
+    virtual void sync() = 0;
+
+    ///
+    /// Return number of queued statements, including already synchronized
+    ///
+    virtual std::size_t size() = 0;
+
+    ///
+    /// Return error message of statement \a i, empty string if it succeeded or is not synchronized yet
+    ///
+    virtual const std::string& error(std::size_t i) = 0;
+
+    ///
+    /// Return number of rows affected by statement \a i
+    ///
+    virtual unsigned long long affected(std::size_t i) = 0;
+
+    ///
+    /// Return result of query \a i. Could be called once per query.
+    ///
+    virtual result_ptr result(std::size_t i) = 0;
+};
+
+///
+/// Loader of many rows into single table using database specific bulk protocol
+///
+struct bulk_writer_iface : public ref_cnt
+{
+    virtual ~bulk_writer_iface() {}
+
+    ///
+    /// Return statement used to bind values of current row. Columns are numbered from 1 in order 
+    /// of columns list and could be bound by name. The statement can`t be executed.
+    ///
+    virtual statement_ptr row() = 0;
+
+    ///
+    /// Append current row to the data being loaded. Bindings should be reset after that.
+    ///
+    virtual void end_row() = 0;
+
+    ///
+    /// Append rows read from \a in that are already encoded in text format of the backend bulk protocol.
+    ///
+    virtual void write_raw(std::istream& in) = 0;
+
+    ///
+    /// Send all buffered rows and finish loading. Return number of loaded rows.
+    ///
+    virtual unsigned long long finish() = 0;
+
+    ///
+    /// Return number of rows rejected by database without failing the load, valid after finish().
+    ///
+    virtual unsigned long long skipped() = 0;
+
+    ///
+    /// Abort loading. Rows already sent are discarded if backend loads data in single operation
+    /// or inside of transaction. MUST never throw.
+    ///
+    virtual void cancel() = 0;
+};
+
+///
+/// Handle of single blob value stored in database, it is read and written by chunks without loading whole value
+///
+struct blob_iface : public ref_cnt
+{
+    virtual ~blob_iface() {}
+
+    ///
+    /// Return size of blob in bytes, it can`t be changed through the handle.
+    ///
+    virtual boost::uint64_t size() = 0;
+
+    ///
+    /// Read up to \a n bytes starting from \a offset into \a buf. Return number of bytes read, it is less than
+    /// \a n only at the end of blob.
+    ///
+    virtual std::size_t read(boost::uint64_t offset, char* buf, std::size_t n) = 0;
+
+    ///
+    /// Write \a n bytes from \a buf starting from \a offset. MUST throw edba_error if blob was opened for reading
+    /// or written range doesn`t fit into blob size.
+    ///
+    virtual void write(boost::uint64_t offset, const char* buf, std::size_t n) = 0;
+};
+
 struct connection_iface : public ref_cnt
 {
     virtual ~connection_iface() {}
@@ -139,6 +402,11 @@ struct connection_iface : public ref_cnt
     ///
     virtual statement_ptr prepare_statement(const string_ref& q) = 0;
 
+    ///
+    /// Same as prepare_statement(const string_ref&), but use query slot for statement lookup.
+    ///
+    virtual statement_ptr prepare_statement(const query_handle& q) = 0;
+
     ///
     /// Create a (unprepared) statement \a q. May throw if had failed.
     /// Should never return null value.
@@ -206,6 +474,43 @@ struct connection_iface : public ref_cnt
     /// Return conn_info object provided for connection during construction
     ///
     virtual const conn_info& connection_info() const = 0;
+    ///
+    /// Return counters of prepared statements cache
+    ///
+    virtual statement_cache_stats cache_stats() const = 0;
+    ///
+    /// Create pipeline for sending several statements in one round trip. 
+    /// MUST throw not_supported_by_backend() if it is not supported.
+    ///
+    virtual pipeline_ptr create_pipeline() = 0;
+    ///
+    /// Create bulk writer into \a table. \a columns is comma separated list of columns to load, all columns
+    /// are loaded if it is empty. Connection can`t be used for other statements until writer finishes or cancels loading.
+    /// MUST throw not_supported_by_backend() if it is not supported.
+    ///
+    virtual bulk_writer_ptr create_bulk_writer(const string_ref& table, const string_ref& columns, bulk_format format) = 0;
+    ///
+    /// Export result of query \a q in \a format passing data to \a sink as soon as it is received. Return number of exported rows.
+    /// If sink throws, export MUST be aborted and connection left usable.
+    /// MUST throw not_supported_by_backend() if it is not supported.
+    ///
+    virtual unsigned long long copy_to(const string_ref& q, bulk_format format, const copy_sink& sink) = 0;
+    ///
+    /// Copy database into file \a path by \a pages_per_step pages, all pages are copied at once if it is negative.
+    /// \a progress is called after each step if it is not empty.
+    /// MUST throw not_supported_by_backend() if it is not supported.
+    ///
+    virtual void backup_to(const string_ref& path, int pages_per_step, const backup_progress& progress) = 0;
+    ///
+    /// Replace database with copy of file \a path, arguments are the same as for backup_to.
+    /// MUST throw not_supported_by_backend() if it is not supported.
+    ///
+    virtual void restore_from(const string_ref& path, int pages_per_step, const backup_progress& progress) = 0;
+    ///
+    /// Open blob stored in \a column of \a table in row \a rowid for reading, or for writing if \a writable is true.
+    /// MUST throw not_supported_by_backend() if it is not supported.
+    ///
+    virtual blob_ptr open_blob(const string_ref& table, const string_ref& column, long long rowid, bool writable) = 0;
 };
 
 }} // namespace edba, backend
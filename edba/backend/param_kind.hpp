@@ -0,0 +1,99 @@
+#ifndef EDBA_BACKEND_PARAM_KIND_HPP
+#define EDBA_BACKEND_PARAM_KIND_HPP
+
+#include <edba/types.hpp>
+#include <edba/errors.hpp>
+#include <edba/detail/utils.hpp>
+
+#include <boost/variant/static_visitor.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
+#include <boost/utility/enable_if.hpp>
+
+#include <ctime>
+#include <iomanip>
+#include <istream>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <string>
+
+namespace edba { namespace backend {
+
+/// Kind of values bound to single parameter over all rows of bind_rows, used by backends
+/// to choose common type of parameter array
+enum param_kind
+{
+    null_param,
+    integer_param,
+    floating_param,
+    time_param,
+    text_param
+};
+
+/// Kind of parameter that can hold values of both kinds \a a and \a b
+inline param_kind combine_param_kinds(param_kind a, param_kind b)
+{
+    if (a == b || null_param == b)
+        return a;
+
+    if (null_param == a)
+        return b;
+
+    if ((integer_param == a || floating_param == a) && (integer_param == b || floating_param == b))
+        return floating_param;
+
+    return text_param;
+}
+
+struct param_kind_of : boost::static_visitor<param_kind>
+{
+    template<typename T>
+    param_kind operator()(const T&) const
+    {
+        return std::numeric_limits<T>::is_integer ? integer_param : floating_param;
+    }
+
+    param_kind operator()(null_type) const { return null_param; }
+    param_kind operator()(const string_ref&) const { return text_param; }
+    param_kind operator()(const std::tm&) const { return time_param; }
+    param_kind operator()(std::istream*) const { return text_param; }
+};
+
+/// Value of integer_param or floating_param parameter, throw bad_value_cast for other kinds
+template<typename Number>
+struct param_number : boost::static_visitor<Number>
+{
+    template<typename T>
+    Number operator()(const T& v, typename boost::enable_if< boost::is_arithmetic<T> >::type* = 0) const
+    {
+        return static_cast<Number>(v);
+    }
+
+    template<typename T>
+    Number operator()(const T&, typename boost::disable_if< boost::is_arithmetic<T> >::type* = 0) const
+    {
+        throw bad_value_cast();
+    }
+};
+
+/// Value of text_param parameter, numbers and times are converted to text
+struct param_text : boost::static_visitor<std::string>
+{
+    template<typename T>
+    std::string operator()(const T& v) const
+    {
+        std::ostringstream ss;
+        ss.imbue(std::locale::classic());
+        ss << std::setprecision(std::numeric_limits<T>::digits10 + 1) << v;
+        return ss.str();
+    }
+
+    std::string operator()(null_type) const { return std::string(); }
+    std::string operator()(const string_ref& v) const { return std::string(v.begin(), v.end()); }
+    std::string operator()(const std::tm& v) const { return format_time(v); }
+    std::string operator()(std::istream*) const { throw bad_value_cast(); }
+};
+
+}} // namespace edba, backend
+
+#endif // EDBA_BACKEND_PARAM_KIND_HPP
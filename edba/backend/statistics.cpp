@@ -135,4 +135,41 @@ statement_stat::measure_statement::~measure_statement()
     }
 }
 
+statement_stat::measure_batch::measure_batch(
+    statement_stat* stat, const std::string* query, std::size_t rows, const unsigned long long* affected
+  )
+  : stat_(stat)
+  , query_(query)
+  , rows_(rows)
+  , affected_(affected)
+{
+    stat_->timer_.restart();
+}
+
+statement_stat::measure_batch::~measure_batch()
+{
+    double execution_time = stat_->timer_.elapsed();
+    stat_->session_stat_->add_query_time(execution_time);
+
+    if (stat_->session_stat_->user_monitor())
+    {
+        bool succeded = !std::uncaught_exception();
+
+        std::ostringstream bindings;
+        bindings << "[batch of " << rows_ << " rows]";
+
+        try 
+        {
+            stat_->session_stat_->user_monitor()->statement_executed(
+                query_->c_str(), bindings.str(), succeded, execution_time, succeded ? *affected_ : 0);
+        }
+        catch(...)
+        {
+            // Rethrow only if there is no active exception already
+            if(succeded)
+                throw;
+        }
+    }
+}
+
 }}
@@ -84,6 +84,18 @@ struct statement_stat
         statement_iface* st_;
     };
 
+    struct measure_batch
+    {
+        measure_batch(statement_stat* stat, const std::string* query, std::size_t rows, const unsigned long long* affected);
+        ~measure_batch();
+
+    private:
+        statement_stat* stat_;
+        const std::string* query_;
+        std::size_t rows_;
+        const unsigned long long* affected_;
+    };
+
     statement_stat(session_stat* st)
       : session_stat_(st)
     {
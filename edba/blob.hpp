@@ -0,0 +1,112 @@
+#ifndef EDBA_BLOB_HPP
+#define EDBA_BLOB_HPP
+
+#include <edba/backend/interfaces.hpp>
+#include <edba/errors.hpp>
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace edba {
+
+/// \brief Handle of single blob value that is read and written by chunks, so the whole value is never held in memory
+///
+/// Blob size can`t be changed through the handle, so large value is usually inserted as zeroblob of the required
+/// size and then filled by chunks. Handle becomes invalid when the row is changed or deleted by other statement.
+///
+/// This object is usually created via session::open_blob() function.
+///
+/// \code
+/// std::ifstream f("image.png", std::ios::binary);
+/// edba::statement st = sess << "insert into images(data) values(:data)" << edba::zeroblob(file_size) << edba::exec;
+/// edba::blob b = sess.open_blob("images", "data", st.last_insert_id(), true);
+/// b.write_from(f);
+/// \endcode
+///
+/// Supported only by SQLite3 backend, other backends throw not_supported_by_backend.
+class blob
+{
+public:
+    /// Create an empty handle, any call except assignment throws empty_statement
+    blob()
+    {
+    }
+
+    /// Return size of blob in bytes
+    boost::uint64_t size()
+    {
+        check("size");
+        return blob_->size();
+    }
+
+    /// Read up to \a n bytes starting from \a offset into \a buf. Return number of bytes read, it is less 
+    /// than \a n only at the end of blob.
+    std::size_t read(boost::uint64_t offset, char* buf, std::size_t n)
+    {
+        check("read");
+        return blob_->read(offset, buf, n);
+    }
+
+    /// Write \a n bytes from \a buf starting from \a offset. Throw edba_error if blob was opened for reading
+    /// or the data doesn`t fit into blob size.
+    void write(boost::uint64_t offset, const char* buf, std::size_t n)
+    {
+        check("write");
+        blob_->write(offset, buf, n);
+    }
+
+    /// Copy whole blob into \a out by chunks of \a chunk_size bytes. Return number of copied bytes.
+    boost::uint64_t read_to(std::ostream& out, std::size_t chunk_size = 64 * 1024)
+    {
+        check("read_to");
+        std::vector<char> chunk(chunk_size ? chunk_size : 1);
+        boost::uint64_t offset = 0;
+        while(std::size_t n = blob_->read(offset, &chunk[0], chunk.size()))
+        {
+            out.write(&chunk[0], n);
+            offset += n;
+        }
+        return offset;
+    }
+
+    /// Fill blob from beginning with data read from \a in by chunks of \a chunk_size bytes until the end of stream.
+    /// Return number of copied bytes. Throw edba_error if the stream has more data than fits into blob.
+    boost::uint64_t write_from(std::istream& in, std::size_t chunk_size = 64 * 1024)
+    {
+        check("write_from");
+        std::vector<char> chunk(chunk_size ? chunk_size : 1);
+        boost::uint64_t offset = 0;
+        while(in.read(&chunk[0], chunk.size()) || in.gcount())
+        {
+            std::size_t n = static_cast<std::size_t>(in.gcount());
+            blob_->write(offset, &chunk[0], n);
+            offset += n;
+        }
+        return offset;
+    }
+
+private:
+    friend class session;
+
+    blob(const backend::connection_ptr& conn, const backend::blob_ptr& b)
+      : conn_(conn)
+      , blob_(b)
+    {
+    }
+
+    void check(const char* api)
+    {
+        if (!blob_)
+            throw empty_statement(api);
+    }
+
+    // Note that order of members is not random.
+    // Blob should be closed before connection
+    backend::connection_ptr conn_;
+    backend::blob_ptr blob_;
+};
+
+}
+
+#endif // EDBA_BLOB_HPP
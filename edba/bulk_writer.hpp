@@ -0,0 +1,135 @@
+#ifndef EDBA_BULK_WRITER_HPP
+#define EDBA_BULK_WRITER_HPP
+
+#include <edba/statement.hpp>
+
+namespace edba {
+
+/// \brief Loader of many rows into single table using database bulk protocol
+///
+/// Values are bound with the same conversions as statement parameters, so tuples and adapted structs
+/// from types_support headers can be written as whole rows. Rows are buffered and sent in large chunks.
+/// Connection can`t be used for other statements until finish() or cancel() is called, writer that
+/// is destroyed without finish() cancels loading.
+///
+/// PostgreSQL loads data with COPY FROM STDIN. MySQL loads data with LOAD DATA LOCAL INFILE fed from memory,
+/// it requires opt_local_infile=1 connection option and sends every 16MB of rows as separate load, so
+/// it should be used inside of transaction to make cancel() discard all rows.
+///
+/// This object is usually created via session::create_bulk_writer() function.
+///
+/// \code
+/// edba::bulk_writer w = sess.create_bulk_writer("test", "id, name");
+/// for(int i = 0; i < 1000000; ++i)
+///     w.write(boost::make_tuple(i, "name"));
+/// w.finish();
+/// \endcode
+class bulk_writer
+{
+public:
+    /// Create an empty writer, any call except assignment throws empty_statement
+    bulk_writer()
+    {
+    }
+
+    /// Bind value \a v to the next column of current row
+    template<typename T>
+    bulk_writer& operator<<(const T& v)
+    {
+        check("bind");
+        row_.bind(v);
+        return *this;
+    }
+
+    /// Bind value \a v to column \a col (starting from 1) of current row
+    template<typename T>
+    bulk_writer& bind(int col, const T& v)
+    {
+        check("bind");
+        row_.bind(col, v);
+        return *this;
+    }
+
+    /// Bind value \a v to column \a name of current row
+    template<typename T>
+    bulk_writer& bind(const string_ref& name, const T& v)
+    {
+        check("bind");
+        row_.bind(name, v);
+        return *this;
+    }
+
+    /// Append current row to loaded data
+    bulk_writer& end_row()
+    {
+        check("end_row");
+        writer_->end_row();
+        row_.reset_bindings();
+        return *this;
+    }
+
+    /// Bind all columns from \a r and append the row, same as w << r; w.end_row();
+    template<typename T>
+    bulk_writer& write(const T& r)
+    {
+        check("write");
+        row_.reset_bindings();
+        row_.bind(r);
+        return end_row();
+    }
+
+    /// Append rows from \a in that are already encoded in text format of the database bulk protocol,
+    /// e.g. tab separated lines produced by export of the same database
+    bulk_writer& write_raw(std::istream& in)
+    {
+        check("write_raw");
+        writer_->write_raw(in);
+        return *this;
+    }
+
+    /// Send remaining rows and finish loading. Return number of loaded rows.
+    unsigned long long finish()
+    {
+        check("finish");
+        return writer_->finish();
+    }
+
+    /// Return number of rows rejected by database without failing the load, e.g. rows with duplicate keys
+    /// skipped by MySQL. Valid after finish().
+    unsigned long long skipped()
+    {
+        check("skipped");
+        return writer_->skipped();
+    }
+
+    /// Abort loading, see class description for what happens with rows already sent
+    void cancel()
+    {
+        check("cancel");
+        writer_->cancel();
+    }
+
+private:
+    friend class session;
+
+    bulk_writer(const backend::connection_ptr& conn, const backend::bulk_writer_ptr& writer)
+      : row_(conn, writer->row())
+      , writer_(writer)
+    {
+    }
+
+    void check(const char* api)
+    {
+        if (!writer_)
+            throw empty_statement(api);
+    }
+
+    // Note that order of members is not random.
+    // Writer should be destroyed before row statement that keeps connection
+    statement row_;
+    backend::bulk_writer_ptr writer_;
+};
+
+}
+
+#endif // EDBA_BULK_WRITER_HPP
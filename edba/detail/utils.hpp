@@ -10,11 +10,13 @@
 #include <boost/preprocessor/stringize.hpp>
 #include <boost/intrusive_ptr.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/cstdint.hpp>
 
 #include <cstdio>
 #include <string>
 #include <sstream>
 #include <ctime>
+#include <limits>
 #include <map>
 
 namespace edba {
@@ -24,11 +26,13 @@ namespace edba {
 #  define EDBA_STRNCPY(Dest, Source, Size) strncpy_s(Dest, Source, Size)
 #  define EDBA_SSCANF sscanf_s
 #  define EDBA_SNPRINTF _snprintf_s
+#  define EDBA_LOCALTIME(Time, Tm) localtime_s(Tm, Time)
 #else
 #  define EDBA_MEMCPY(Dst, BufSize, Src, ToCopy) memcpy(Dst, Src, ToCopy)
 #  define EDBA_STRNCPY(Dest, Source, Size) strncpy(Dest, Source, Size)
 #  define EDBA_SSCANF sscanf
 #  define EDBA_SNPRINTF snprintf
+#  define EDBA_LOCALTIME(Time, Tm) localtime_r(Time, Tm)
 #endif
 
 inline long long atoll(const char* val)
@@ -90,6 +94,22 @@ IterRange trim(const IterRange& rng)
     return rng_copy;
 }
 
+///
+/// \brief 64-bit FNV-1a hash of query text.
+///
+/// Used by connections to index statement cache.
+///
+inline boost::uint64_t hash_query(const string_ref& q)
+{
+    boost::uint64_t h = 14695981039346656037ULL;
+    for(const char* p = q.begin(); p != q.end(); ++p)
+    {
+        h ^= static_cast<unsigned char>(*p);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
 template<typename T>
 T* make_pointer(T& value)
 {
@@ -151,6 +171,41 @@ EDBA_API void parse_number(const string_ref& r, float& num);
 EDBA_API void parse_number(const string_ref& r, double& num);
 EDBA_API void parse_number(const string_ref& r, long double& num);
 
+///
+/// \brief assign integer fetched from database to \a v, throw bad_value_cast if it is out of range of T
+///
+/// Used by backend implementations;
+///
+template<typename T>
+void assign_integer(long long x, T& v)
+{
+    T casted = static_cast<T>(x);
+    if (std::numeric_limits<T>::is_integer 
+        && (static_cast<long long>(casted) != x || (x < 0 && !std::numeric_limits<T>::is_signed)))
+        throw bad_value_cast();
+
+    v = casted;
+}
+
+///
+/// \brief assign floating point value fetched from database to \a v, throw bad_value_cast if it is out of range of T
+///
+/// Used by backend implementations;
+///
+template<typename T>
+void assign_floating(double x, T& v)
+{
+    if (std::numeric_limits<T>::is_integer)
+    {
+        if (!(x > -9.2e18 && x < 9.2e18))
+            throw bad_value_cast();
+
+        assign_integer(static_cast<long long>(x), v);
+    }
+    else
+        v = static_cast<T>(x);
+}
+
 struct ref_cnt : boost::noncopyable
 {
     ref_cnt() : cnt_(0) {}
@@ -4,5 +4,6 @@
 #include <edba/session_pool.hpp>
 #include <edba/session.hpp>
 #include <edba/transaction.hpp>
+#include <edba/pipeline.hpp>
 
 #endif // EDBA_EDBA_HPP
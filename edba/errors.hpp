@@ -7,6 +7,7 @@
 
 #include <stdexcept>
 #include <string>
+#include <cstddef>
 
 namespace edba {
 
@@ -114,6 +115,24 @@ public:
     }
 };
 
+/// \brief Statement queued into pipeline has failed
+class EDBA_API pipeline_error : public edba_error
+{
+public:
+    pipeline_error(std::size_t index, std::string const &e) : edba_error(e), index_(index)
+    {
+    }
+
+    /// Return index of failed statement in pipeline
+    std::size_t index() const
+    {
+        return index_;
+    }
+
+private:
+    std::size_t index_;
+};
+
 /// \brief Attempt to create row iterator for a second time
 class EDBA_API multiple_rowset_traverse : public edba_error
 {
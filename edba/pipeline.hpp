@@ -0,0 +1,119 @@
+#ifndef EDBA_PIPELINE_HPP
+#define EDBA_PIPELINE_HPP
+
+#include <edba/session.hpp>
+
+namespace edba {
+
+/// \brief Queue of statements sent to database in single round trip
+///
+/// Statements are queued with their current bindings, bindings are reset after queueing so the same statement
+/// can be queued many times with different parameters. Queued statements are sent together by sync(), after that
+/// their affected rows and query results are available by index returned on queueing.
+///
+/// Statements between synchronization points are executed in single implicit transaction unless an explicit
+/// transaction is active, so failure of one statement causes skipping of the following ones.
+///
+/// \code
+/// edba::pipeline p(sess);
+/// edba::statement st = sess << "insert into test(id) values(:id)";
+/// for(int i = 0; i < 100; ++i)
+///     p.exec(st << i);
+/// edba::statement sel = sess << "select count(*) from test";
+/// std::size_t q = p.query(sel);
+/// p.sync();
+/// int count;
+/// p.result(q).begin()->fetch(0, count);
+/// \endcode
+///
+/// Supported only by PostgreSQL backend built with libpq 14 or later, other backends throw not_supported_by_backend.
+class pipeline : boost::noncopyable
+{
+public:
+    /// Create pipeline for session \a s
+    explicit pipeline(session& s)
+      : conn_(s.conn_)
+      , synced_(0)
+    {
+        if (!conn_)
+            throw empty_session("pipeline");
+
+        impl_ = conn_->create_pipeline();
+    }
+
+    /// Queue execution of \a st with its current bindings and reset its bindings. Return index of queued statement.
+    std::size_t exec(statement& st)
+    {
+        if (!st.stmt_)
+            throw empty_statement("pipeline::exec");
+
+        std::size_t i = impl_->exec(st.stmt_);
+        stmts_.push_back(st.stmt_);
+        st.reset_bindings();
+        return i;
+    }
+
+    /// Queue query \a st with its current bindings and reset its bindings. Return index of queued query.
+    std::size_t query(statement& st)
+    {
+        if (!st.stmt_)
+            throw empty_statement("pipeline::query");
+
+        std::size_t i = impl_->query(st.stmt_);
+        stmts_.push_back(st.stmt_);
+        st.reset_bindings();
+        return i;
+    }
+
+    /// Send queued statements and receive their results. Throw pipeline_error for the first failed statement,
+    /// results of other statements are available anyway.
+    void sync()
+    {
+        std::size_t first = synced_;
+        impl_->sync();
+        synced_ = impl_->size();
+
+        for(std::size_t i = first; i < synced_; ++i)
+        {
+            if (!impl_->error(i).empty())
+                throw pipeline_error(i, impl_->error(i));
+        }
+    }
+
+    /// Return number of queued statements
+    std::size_t size() const
+    {
+        return impl_->size();
+    }
+
+    /// Return error message of statement \a i, empty if it succeeded or is not synchronized yet
+    const std::string& error(std::size_t i) const
+    {
+        return impl_->error(i);
+    }
+
+    /// Return number of rows affected by statement \a i. Throw pipeline_error if the statement has failed.
+    unsigned long long affected(std::size_t i)
+    {
+        return impl_->affected(i);
+    }
+
+    /// Return result of query \a i. Throw pipeline_error if the query has failed.
+    rowset<> result(std::size_t i)
+    {
+        backend::result_ptr res = impl_->result(i);
+        return rowset<>(conn_, stmts_.at(i), res);
+    }
+
+private:
+    // Note that order of members is not random.
+    // It is very important to destroy pipeline at first, then statements and only then connection
+    backend::connection_ptr conn_;
+    std::vector<backend::statement_ptr> stmts_;
+    backend::pipeline_ptr impl_;
+    std::size_t synced_;    // number of statements sent by sync()
+};
+
+}
+
+#endif // EDBA_PIPELINE_HPP
@@ -0,0 +1,31 @@
+#include <edba/query_handle.hpp>
+
+#include <edba/detail/utils.hpp>
+
+#include <boost/smart_ptr/detail/atomic_count.hpp>
+
+namespace edba {
+
+namespace {
+    boost::detail::atomic_count g_slots_count(0);
+}
+
+query_handle::query_handle(const char* text)
+{
+    init(string_ref(text));
+}
+
+query_handle::query_handle(const string_ref& text)
+{
+    init(text);
+}
+
+void query_handle::init(const string_ref& text)
+{
+    string_ref trimmed = trim(text);
+    text_.assign(trimmed.begin(), trimmed.end());
+    hash_ = hash_query(text_);
+    slot_ = static_cast<unsigned>(++g_slots_count - 1);
+}
+
+}
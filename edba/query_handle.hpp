@@ -0,0 +1,64 @@
+#ifndef EDBA_QUERY_HANDLE_HPP
+#define EDBA_QUERY_HANDLE_HPP
+
+#include <edba/detail/exports.hpp>
+#include <edba/string_ref.hpp>
+
+#include <boost/cstdint.hpp>
+
+#include <string>
+
+namespace edba {
+
+/// \brief Handle for frequently executed query
+///
+/// Query text is trimmed and hashed only once during construction. Each query object also gets 
+/// unique slot index which is used by connections to keep prepared statement for this query. 
+/// That is why statement lookup for query handle doesn`t touch SQL text at all:
+/// \code
+/// static const edba::query_handle select_user("select name from users where id = :id");
+/// ...
+/// sess << select_user << id << first_row >> name;
+/// \endcode
+///
+/// Slots are never reused, so query objects are intended to be long living ones, usually statics.
+/// Statements prepared through query handles are held by connection until it is closed and 
+/// are not subject for eviction from statement cache.
+class EDBA_API query_handle
+{
+public:
+    /// Create query handle for SQL text \a text
+    explicit query_handle(const char* text);
+
+    /// Create query handle for SQL text \a text
+    explicit query_handle(const string_ref& text);
+
+    /// Return trimmed query text
+    string_ref text() const
+    {
+        return string_ref(text_);
+    }
+
+    /// Return precomputed hash of trimmed query text
+    boost::uint64_t hash() const
+    {
+        return hash_;
+    }
+
+    /// Return slot index of query in connection statement table
+    unsigned slot() const
+    {
+        return slot_;
+    }
+
+private:
+    void init(const string_ref& text);
+
+    std::string text_;
+    boost::uint64_t hash_;
+    unsigned slot_;
+};
+
+}
+
+#endif // EDBA_QUERY_HANDLE_HPP
@@ -2,9 +2,14 @@
 #define EDBA_SESSION_HPP
 
 #include <edba/statement.hpp>
+#include <edba/bulk_writer.hpp>
+#include <edba/blob.hpp>
+#include <edba/query_handle.hpp>
 #include <edba/conn_info.hpp>
 #include <edba/driver_manager.hpp>
 
+#include <ostream>
+
 namespace edba {
 
 class session_pool;
@@ -28,6 +33,20 @@ class session
         session* sess_;
     };
 
+    struct ostream_sink
+    {
+        ostream_sink(std::ostream& out) : out_(&out) {}
+
+        void operator()(const char* data, std::size_t size) const
+        {
+            if (!out_->write(data, static_cast<std::streamsize>(size)))
+                throw edba_error("edba::session::copy_to failed writing to output stream");
+        }
+
+    private:
+        std::ostream* out_;
+    };
+
 public:   
     /// Create an empty session object, it should not be used until it is opened with calling open() function.
     session()
@@ -69,6 +88,17 @@ public:
         return statement(conn_, stmt);
     }
 
+    /// Same as prepare_statement(const string_ref&) but use query handle \a q for fast statement lookup.
+    /// It is the fastest way to get statements which are executed very often.
+    statement prepare_statement(const query_handle& q)
+    {
+        if (!conn_)
+            throw empty_session("prepare_statement");
+
+        backend::statement_ptr stmt(conn_->prepare_statement(q));
+        return statement(conn_, stmt);
+    }
+
     /// Create unprepared statement which is never cached. It should
     /// be used when such statement is executed rarely or very customized.
     statement create_statement(const string_ref& q)
@@ -90,6 +120,86 @@ public:
         return once_type(this);
     }
 
+    /// Create writer for loading many rows into \a table using database bulk protocol.
+    /// \a columns is comma separated list of loaded columns, all columns are loaded if it is empty.
+    ///
+    /// Throw not_supported_by_backend if backend has no bulk protocol support.
+    bulk_writer create_bulk_writer(const string_ref& table, const string_ref& columns = string_ref(), bulk_format format = bulk_text_format)
+    {
+        if (!conn_)
+            throw empty_session("create_bulk_writer");
+
+        return bulk_writer(conn_, conn_->create_bulk_writer(table, columns, format));
+    }
+
+    /// Export result of query \a q using database bulk protocol. Data is passed to \a sink as soon as it is received
+    /// and is never accumulated in memory, in text format each call receives single row terminated with newline.
+    /// Return number of exported rows.
+    ///
+    /// Throw not_supported_by_backend if backend has no bulk protocol support.
+    unsigned long long copy_to(const string_ref& q, const copy_sink& sink, bulk_format format = bulk_text_format)
+    {
+        if (!conn_)
+            throw empty_session("copy_to");
+
+        return conn_->copy_to(q, format, sink);
+    }
+
+    /// Export result of query \a q using database bulk protocol into stream \a out. Return number of exported rows.
+    ///
+    /// \code
+    /// std::ofstream f("users.tsv", std::ios::binary);
+    /// sess.copy_to("select id, name from users", f);
+    /// \endcode
+    unsigned long long copy_to(const string_ref& q, std::ostream& out, bulk_format format = bulk_text_format)
+    {
+        return copy_to(q, copy_sink(ostream_sink(out)), format);
+    }
+
+    /// Copy database of the session into file \a path while session stays usable, existing file is overwritten.
+    /// Database is copied by \a pages_per_step pages, or all at once if it is negative. \a progress is called
+    /// after each step, so it can throttle copying by sleeping between steps.
+    ///
+    /// Throw not_supported_by_backend if backend has no online backup support.
+    void backup_to(const string_ref& path, int pages_per_step = -1, const backup_progress& progress = backup_progress())
+    {
+        if (!conn_)
+            throw empty_session("backup_to");
+
+        conn_->backup_to(path, pages_per_step, progress);
+    }
+
+    /// Replace database of the session with copy of file \a path, arguments are the same as for backup_to().
+    /// It is usually used to load database into memory at startup and backup_to() writes it back periodically:
+    ///
+    /// \code
+    /// edba::session sess("sqlite3:db=:memory:");
+    /// sess.restore_from("app.db");
+    /// // ... queries served from memory ...
+    /// sess.backup_to("app.db", 1024);
+    /// \endcode
+    ///
+    /// Throw not_supported_by_backend if backend has no online backup support.
+    void restore_from(const string_ref& path, int pages_per_step = -1, const backup_progress& progress = backup_progress())
+    {
+        if (!conn_)
+            throw empty_session("restore_from");
+
+        conn_->restore_from(path, pages_per_step, progress);
+    }
+
+    /// Open blob stored in \a column of \a table in row \a rowid for reading by chunks, or for writing if \a writable
+    /// is true. Blob size can`t be changed, so value to be written is usually inserted as zeroblob first.
+    ///
+    /// Throw not_supported_by_backend if backend has no incremental blob access support.
+    blob open_blob(const string_ref& table, const string_ref& column, long long rowid, bool writable = false)
+    {
+        if (!conn_)
+            throw empty_session("open_blob");
+
+        return blob(conn_, conn_->open_blob(table, column, rowid, writable));
+    }
+
     /// Execute list of sql commands as single request to database
     void exec_batch(const string_ref& q)
     {
@@ -226,6 +336,16 @@ public:
         return conn_->connection_info();
     }
 
+    /// Return hit, miss and eviction counters of prepared statements cache. Cache capacity
+    /// is controlled by \@stmt_cache_size connection string option.
+    statement_cache_stats cache_stats() const
+    {
+        if (!conn_)
+            throw empty_session("cache_stats");
+
+        return conn_->cache_stats();
+    }
+
     /// Equality operator
     friend bool operator==(const session& s1, const session& s2)
     {
@@ -238,8 +358,15 @@ public:
         return prepare_statement(query);
     }    
 
+    /// Syntactic sugar, same as prepare(q)
+    statement operator<<(const query_handle& q)
+    {
+        return prepare_statement(q);
+    }
+
 private:
     friend class session_pool;
+    friend class pipeline;
 
     session(const backend::connection_ptr& conn)
       : conn_(conn)
@@ -5,8 +5,9 @@ namespace edba {
 
 struct session_pool::connection_proxy : backend::connection_iface
 {
-    connection_proxy(session_pool& pool, const backend::connection_ptr& conn) 
+    connection_proxy(session_pool& pool, sessions& owner, const backend::connection_ptr& conn) 
       : pool_(pool)
+      , owner_(owner)
       , conn_(conn)
       , exec_time_on_init_(conn->total_execution_time())
     {        
@@ -16,8 +17,8 @@ struct session_pool::connection_proxy : backend::connection_iface
     {
         mutex::scoped_lock g(pool_.pool_guard_);
         pool_.total_sec_ += conn_->total_execution_time() - exec_time_on_init_;
-        pool_.pool_.push_back(conn_);
-        pool_.pool_max_cv_.notify_one();
+        owner_.pool_.push_back(conn_);
+        owner_.pool_max_cv_.notify_one();
     }
 
     virtual backend::statement_ptr prepare_statement(const string_ref& q)
@@ -25,6 +26,11 @@ struct session_pool::connection_proxy : backend::connection_iface
         return conn_->prepare_statement(q);
     }
 
+    virtual backend::statement_ptr prepare_statement(const query_handle& q)
+    {
+        return conn_->prepare_statement(q);
+    }
+
     virtual backend::statement_ptr create_statement(const string_ref& q)
     {
         return conn_->create_statement(q);
@@ -95,19 +101,68 @@ struct session_pool::connection_proxy : backend::connection_iface
         return conn_->connection_info();
     }
 
+    virtual statement_cache_stats cache_stats() const
+    {
+        return conn_->cache_stats();
+    }
+
+    virtual backend::pipeline_ptr create_pipeline()
+    {
+        return conn_->create_pipeline();
+    }
+
+    virtual backend::bulk_writer_ptr create_bulk_writer(const string_ref& table, const string_ref& columns, bulk_format format)
+    {
+        return conn_->create_bulk_writer(table, columns, format);
+    }
+
+    virtual unsigned long long copy_to(const string_ref& q, bulk_format format, const copy_sink& sink)
+    {
+        return conn_->copy_to(q, format, sink);
+    }
+
+    virtual void backup_to(const string_ref& path, int pages_per_step, const backup_progress& progress)
+    {
+        return conn_->backup_to(path, pages_per_step, progress);
+    }
+
+    virtual void restore_from(const string_ref& path, int pages_per_step, const backup_progress& progress)
+    {
+        return conn_->restore_from(path, pages_per_step, progress);
+    }
+
+    virtual backend::blob_ptr open_blob(const string_ref& table, const string_ref& column, long long rowid, bool writable)
+    {
+        return conn_->open_blob(table, column, rowid, writable);
+    }
+
 private:
     session_pool& pool_;
+    sessions& owner_;
     backend::connection_ptr conn_;
     double exec_time_on_init_;
 };
 
-session_pool::session_pool(const char* conn_string, int max_pool_size, session_monitor* sm)
+session_pool::sessions::sessions(const char* conn_string, int max_size)
     : conn_info_(conn_string)
-    , conn_left_unopened_(max_pool_size)
-    , sm_(sm)
+    , conn_left_unopened_(max_size)
+{
+    pool_.reserve(max_size);
+}
+
+session_pool::session_pool(const char* conn_string, int max_pool_size, session_monitor* sm)
+    : sm_(sm)
     , total_sec_(0.0)
+    , writers_(conn_string, max_pool_size)
+{
+}
+
+session_pool::session_pool(const char* conn_string, int max_pool_size, const char* read_conn_string, int max_readers, session_monitor* sm)
+    : sm_(sm)
+    , total_sec_(0.0)
+    , writers_(conn_string, max_pool_size)
+    , readers_(new sessions(read_conn_string, max_readers))
 {
-    pool_.reserve(max_pool_size);
 }
 
 void session_pool::invoke_on_connect(const conn_init_callback& callback)
@@ -117,18 +172,38 @@ void session_pool::invoke_on_connect(const conn_init_callback& callback)
 }
 
 session session_pool::open()
+{
+    return open(writers_);
+}
+
+bool session_pool::try_open(session& sess)
+{
+    return try_open(writers_, sess);
+}
+
+session session_pool::open_reader()
+{
+    return open(readers_ ? *readers_ : writers_);
+}
+
+bool session_pool::try_open_reader(session& sess)
+{
+    return try_open(readers_ ? *readers_ : writers_, sess);
+}
+
+session session_pool::open(sessions& s)
 {
     mutex::scoped_lock g(pool_guard_);
 
-    if (!pool_.empty())  // take connection from pool
+    if (!s.pool_.empty())  // take connection from pool
     {
-        session sess(create_proxy(pool_.back()));
-        pool_.pop_back();
+        session sess(create_proxy(s, s.pool_.back()));
+        s.pool_.pop_back();
         return sess;
     }
-    else if (pool_.empty() && conn_left_unopened_) // we can create new connection
+    else if (s.pool_.empty() && s.conn_left_unopened_) // we can create new connection
     {
-        backend::connection_ptr conn = driver_manager::create_conn(conn_info_, sm_);
+        backend::connection_ptr conn = driver_manager::create_conn(s.conn_info_, sm_);
 
         if (conn_init_callback_)
             // Don`t use proxy wrapper over connection because in case of exception in conn_init_callback_
@@ -136,39 +211,39 @@ session session_pool::open()
             conn_init_callback_(session(conn));
 
         // Now we can construct session using proxy connection
-        session sess(create_proxy(conn));
-        --conn_left_unopened_;
+        session sess(create_proxy(s, conn));
+        --s.conn_left_unopened_;
 
         return sess;
     }
     else // we must wait until someone will free connection for us
     {
-        pool_max_cv_.wait(g, !boost::bind(&pool_type::empty, &pool_)); 
-        assert(!pool_.empty() && "pool_ is not empty");
+        s.pool_max_cv_.wait(g, !boost::bind(&pool_type::empty, &s.pool_)); 
+        assert(!s.pool_.empty() && "pool_ is not empty");
 
-        session sess(create_proxy(pool_.back()));
-        pool_.pop_back();
+        session sess(create_proxy(s, s.pool_.back()));
+        s.pool_.pop_back();
         return sess;
     }
 }
 
-bool session_pool::try_open(session& sess)
+bool session_pool::try_open(sessions& s, session& sess)
 {
     mutex::scoped_lock g(pool_guard_);
 
-    if (!pool_.empty())  // take connection from pool
+    if (!s.pool_.empty())  // take connection from pool
     {
-        sess = session(create_proxy(pool_.back()));
-        pool_.pop_back();
+        sess = session(create_proxy(s, s.pool_.back()));
+        s.pool_.pop_back();
     }
-    else if (pool_.empty() && conn_left_unopened_) // we can create new connection
+    else if (s.pool_.empty() && s.conn_left_unopened_) // we can create new connection
     {
-        backend::connection_ptr conn = driver_manager::create_conn(conn_info_, sm_);
+        backend::connection_ptr conn = driver_manager::create_conn(s.conn_info_, sm_);
         if (conn_init_callback_)
             conn_init_callback_(session(conn));
 
-        session tmp(create_proxy(conn));
-        --conn_left_unopened_;
+        session tmp(create_proxy(s, conn));
+        --s.conn_left_unopened_;
 
         sess = tmp;
     }
@@ -184,9 +259,9 @@ double session_pool::total_execution_time()
     return total_sec_;
 }
 
-backend::connection_ptr session_pool::create_proxy(const backend::connection_ptr& conn)
+backend::connection_ptr session_pool::create_proxy(sessions& s, const backend::connection_ptr& conn)
 {
-    return backend::connection_ptr(new connection_proxy(*this, conn));
+    return backend::connection_ptr(new connection_proxy(*this, s, conn));
 }
 
 }
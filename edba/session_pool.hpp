@@ -4,12 +4,24 @@
 #include <edba/session.hpp>
 
 #include <boost/function.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/thread/condition_variable.hpp>
 
 namespace edba {
 
 /// Thread-safe pool of sessions with maximum number limit
+///
+/// Pool may also keep separate read-only sessions returned by open_reader(). It lets SQLite readers of database
+/// in WAL mode work in parallel with single writer, instead of serializing all of them on the same connections:
+/// \code
+/// edba::session_pool pool(
+///     "sqlite3:db=app.db;@sqlite_wal=on;@sqlite_nomutex=on", 1
+///   , "sqlite3:db=app.db;mode=readonly;@sqlite_nomutex=on", 8
+///   );
+/// pool.open() << "insert into log(msg) values(:msg)" << msg << edba::exec;
+/// edba::rowset<std::string> rs = pool.open_reader() << "select msg from log";
+/// \endcode
 class EDBA_API session_pool
 {
 public:
@@ -20,6 +32,10 @@ public:
     /// Constructor doesn`t create connection itself, instead they will be created lazily by \a open and \a try_open calls.
     session_pool(const char* conn_string, int max_pool_size, session_monitor* sm = 0);
 
+    /// Construct pool that also keeps up to \a max_readers read-only sessions created using \a read_conn_string.
+    /// Readers are returned by \a open_reader and \a try_open_reader calls, other sessions are created using \a conn_string.
+    session_pool(const char* conn_string, int max_pool_size, const char* read_conn_string, int max_readers, session_monitor* sm = 0);
+
     /// Invoke provided function object once on connection creation. This allow to setup all
     /// sessions in pool in uniform manner. configure call doesn`t affect already created sessions it will be applied only
     /// to the new one.
@@ -33,6 +49,12 @@ public:
     /// If there is no free sessions and max_pool_size limit exceeded then return false and leave sess untouched
     bool try_open(session& sess);
 
+    /// Same as open() but return read-only session. If pool has no readers then it is the same as open().
+    session open_reader();
+
+    /// Same as try_open() but return read-only session. If pool has no readers then it is the same as try_open().
+    bool try_open_reader(session& sess);
+
     /// Return total time in seconds spent by all session on query and statement execution
     double total_execution_time();
 
@@ -42,22 +64,33 @@ private:
     typedef std::vector< backend::connection_ptr > pool_type;
     typedef boost::mutex mutex;
 
-    backend::connection_ptr create_proxy(const backend::connection_ptr& conn);
+    // Sessions created with the same connection string
+    struct sessions
+    {
+        sessions(const char* conn_string, int max_size);
+
+        conn_info conn_info_;
+        int conn_left_unopened_;
+        pool_type pool_;
+        boost::condition_variable pool_max_cv_;
+    };
+
+    session open(sessions& s);
+    bool try_open(sessions& s, session& sess);
+    backend::connection_ptr create_proxy(sessions& s, const backend::connection_ptr& conn);
 
     // NONCOPYABLE
     session_pool(const session_pool&);
     session_pool& operator=(const session_pool&);
 
-    conn_info conn_info_;
-    int conn_left_unopened_;
     session_monitor* sm_;
     double total_sec_;
 
     conn_init_callback conn_init_callback_;
 
-    pool_type pool_;
+    sessions writers_;
+    boost::scoped_ptr<sessions> readers_;   // Empty if pool has no separate readers
     mutex pool_guard_;
-    boost::condition_variable pool_max_cv_;
 };
 
 }                                                                               // namespace edba
@@ -6,6 +6,9 @@
 #include <boost/type_traits/is_convertible.hpp>
 #include <boost/mpl/not.hpp>
 #include <boost/mpl/and.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/iterator.hpp>
 
 namespace edba {
 
@@ -18,6 +21,7 @@ public:
     /// Default constructor, provided for convenience, access to some member function
     /// of empty statement will cause an exception empty_statement being thrown. 
     statement()
+      : batch_(0)
     {
     }
 
@@ -37,6 +41,38 @@ public:
         return *this;
     }
 
+    /// Set how results of subsequent queries are transferred. With streamed_result rows are received
+    /// from server on demand, so memory usage doesn`t depend on result size, rowset::rows() returns -1 and
+    /// connection can`t execute other statements until the result is read or destroyed.
+    /// Backends without streaming support ignore it. Statements taken from cache are always buffered.
+    ///
+    /// Immediatelly exits for empty statements
+    statement& set_result_mode(result_mode m)
+    {
+        if (stmt_)
+            stmt_->set_result_mode(m);
+
+        return *this;
+    }
+
+    /// Set how strings bound later are passed to backend. With static_bind caller guarantees that bound strings
+    /// stay unchanged until the statement is executed and its result is read, so backends that support it
+    /// (SQLite3) use them without copying. Other backends ignore it. Statements taken from cache always copy.
+    ///
+    /// \code
+    /// std::string payload = load_payload();
+    /// sess.create_statement("insert into docs(body) values(?)").set_bind_mode(static_bind) << payload << exec;
+    /// \endcode
+    ///
+    /// Immediatelly exits for empty statements
+    statement& set_bind_mode(bind_mode m)
+    {
+        if (stmt_)
+            stmt_->set_bind_mode(m);
+
+        return *this;
+    }
+
     /// Bind a value \a v to the placeholder by index (starting from the 1).
     ///
     /// Placeholders are marked as ':placeholdername' in the query.
@@ -66,12 +102,31 @@ public:
     /// Immediatelly exits for empty statements
     statement& bind(int col, const bind_types_variant& v)
     {
-        if (stmt_)
+        if (batch_)
+            batch_->add(col, v);
+        else if (stmt_)
             stmt_->bind(col, v);
 
         return *this;
     }
 
+    /// Bind blob of \a v.size_ zero bytes to the placeholder by index (starting from the 1), so its content
+    /// can be written later by session::open_blob() without holding whole value in memory.
+    ///
+    /// Supported only by SQLite3 backend, other backends throw not_supported_by_backend.
+    /// Can`t be used in rows of exec_many().
+    ///
+    /// Immediatelly exits for empty statements
+    statement& bind(int col, const zeroblob& v)
+    {
+        if (batch_)
+            throw edba_error("edba::zeroblob can`t be bound in exec_many");
+        else if (stmt_)
+            stmt_->bind_zeroblob(col, v.size_);
+
+        return *this;
+    }
+
     /// Bind a value \a v to the placeholder by name.
     ///
     /// Placeholders are marked as ':placeholdername' in the query.
@@ -99,7 +154,9 @@ public:
     /// Immediatelly exits for empty statements
     statement& bind(const string_ref& name, const bind_types_variant& v)
     {
-        if (stmt_)
+        if (batch_)
+            batch_->add(name, v);
+        else if (stmt_)
             stmt_->bind(name, v);
 
         return *this;
@@ -236,6 +293,50 @@ public:
             stmt_->run_exec();
     }
 
+    /// Execute a statement once for each element of \a rows and return total number of affected rows.
+    /// Each element is bound as st << element, so it can be any bindable type, e.g. boost::tuple or 
+    /// adapted struct for multiple parameters.
+    ///
+    /// Backends use native bulk execution where it is available, the whole batch is reported to session_monitor
+    /// as single statement. Bindings are reset after execution.
+    ///
+    /// \code
+    /// std::vector< boost::tuple<int, std::string> > rows;
+    /// ...
+    /// statement st = sess << "insert into test(id, name) values(:id, :name)";
+    /// st.exec_many(rows);
+    /// \endcode
+    ///
+    /// Throw empty_statement exception for empty statements
+    template<typename Range>
+    unsigned long long exec_many(const Range& rows)
+    {
+        if (!stmt_)
+            throw empty_statement("exec_many");
+
+        backend::bind_rows batch;
+        batch_ = &batch;
+        try
+        {
+            for(typename boost::range_iterator<const Range>::type it = boost::begin(rows); it != boost::end(rows); ++it)
+            {
+                placeholder_ = 1;
+                bind(*it);
+                batch.end_row();
+            }
+        }
+        catch(...)
+        {
+            batch_ = 0;
+            placeholder_ = 1;
+            throw;
+        }
+        batch_ = 0;
+        placeholder_ = 1;
+
+        return stmt_->run_exec_many(batch);
+    }
+
     // NOTE: Following overloaded operators are members because in case of free functions they need to accept
     // statement by value or const reference. Otherwise the next statement will be illformed because rvalue ref   
     // can`t be casted to non-const lvalue ref.
@@ -291,11 +392,15 @@ public:
 
 private:
     friend class session;
+    friend class pipeline;
+    friend class bulk_writer;
+    template<typename Signature> friend class typed_statement;
 
     statement(const backend::connection_ptr& conn, const backend::statement_ptr& stmt)
       : conn_(conn)
       , stmt_(stmt)
       , placeholder_(1)
+      , batch_(0)
     {
     }
 
@@ -305,6 +410,7 @@ private:
     backend::connection_ptr conn_;
     backend::statement_ptr stmt_;
     int placeholder_;
+    backend::bind_rows* batch_;     // collects parameters instead of binding them while exec_many is running
 };
 
 // ------ free functions ------
@@ -0,0 +1,364 @@
+#if !defined(BOOST_PP_IS_ITERATING)
+
+#  ifndef EDBA_TYPED_STATEMENT_HPP
+#  define EDBA_TYPED_STATEMENT_HPP
+
+#  include <edba/session.hpp>
+
+#  include <boost/fusion/support/is_sequence.hpp>
+#  include <boost/fusion/sequence/intrinsic/size.hpp>
+#  include <boost/fusion/algorithm/iteration/for_each.hpp>
+#  include <boost/fusion/adapted/boost_tuple.hpp>
+#  include <boost/type_traits/is_integral.hpp>
+#  include <boost/type_traits/is_floating_point.hpp>
+#  include <boost/type_traits/is_signed.hpp>
+#  include <boost/type_traits/is_same.hpp>
+#  include <boost/type_traits/is_convertible.hpp>
+#  include <boost/type_traits/remove_cv.hpp>
+#  include <boost/type_traits/remove_reference.hpp>
+#  include <boost/utility/enable_if.hpp>
+#  include <boost/call_traits.hpp>
+#  include <boost/mpl/assert.hpp>
+
+#  include <boost/preprocessor/iteration/iterate.hpp>
+#  include <boost/preprocessor/repetition/enum_params.hpp>
+#  include <boost/preprocessor/repetition/enum_trailing_params.hpp>
+#  include <boost/preprocessor/repetition/enum.hpp>
+#  include <boost/preprocessor/repetition/repeat.hpp>
+
+#  include <limits>
+
+#  ifndef EDBA_TYPED_STATEMENT_MAX_ARITY
+#    define EDBA_TYPED_STATEMENT_MAX_ARITY 10
+#  endif
+
+namespace edba {
+
+///
+/// Mechanism for binding parameters of typed_statement. Supported types are integral and floating point types,
+/// types convertible to string_ref and null_type. Values are passed to backend without bind_types_variant.
+///
+template<typename T, typename Enable = void>
+struct typed_bind_conversion
+{
+    static void bind(backend::statement_iface& st, int col, const T& v)
+    {
+        BOOST_MPL_ASSERT_MSG(false, TYPE_IS_NOT_SUPPORTED_BY_TYPED_STATEMENT, (T));
+    }
+};
+
+template<typename T>
+struct typed_bind_conversion<T, typename boost::enable_if< boost::is_integral<T> >::type>
+{
+    static void bind(backend::statement_iface& st, int col, T v)
+    {
+        if (!boost::is_signed<T>::value &&
+            static_cast<unsigned long long>(v) > static_cast<unsigned long long>((std::numeric_limits<long long>::max)()))
+            throw bad_value_cast();
+
+        st.bind_int64(col, static_cast<long long>(v));
+    }
+};
+
+template<typename T>
+struct typed_bind_conversion<T, typename boost::enable_if< boost::is_floating_point<T> >::type>
+{
+    static void bind(backend::statement_iface& st, int col, T v)
+    {
+        st.bind_double(col, static_cast<double>(v));
+    }
+};
+
+template<typename T>
+struct typed_bind_conversion<T, typename boost::enable_if< boost::is_convertible<T, string_ref> >::type>
+{
+    static void bind(backend::statement_iface& st, int col, const T& v)
+    {
+        st.bind_text(col, string_ref(v));
+    }
+};
+
+template<>
+struct typed_bind_conversion<null_type, void>
+{
+    static void bind(backend::statement_iface& st, int col, null_type)
+    {
+        st.bind_null(col);
+    }
+};
+
+///
+/// Mechanism for fetching columns of typed_statement results. Supported types are integral and floating point types
+/// and std::string. Values are fetched from backend without fetch_types_variant.
+/// NULL values cause null_value_fetch exception.
+///
+template<typename T, typename Enable = void>
+struct typed_fetch_conversion
+{
+    static void fetch(backend::result_iface& res, int col, T& v)
+    {
+        BOOST_MPL_ASSERT_MSG(false, TYPE_IS_NOT_SUPPORTED_BY_TYPED_STATEMENT, (T));
+    }
+};
+
+template<typename T>
+struct typed_fetch_conversion<T, typename boost::enable_if< boost::is_integral<T> >::type>
+{
+    static void fetch(backend::result_iface& res, int col, T& v)
+    {
+        long long tmp;
+        if (!res.fetch_int64(col, tmp))
+            throw null_value_fetch(res.column_to_name(col));
+
+        T casted = static_cast<T>(tmp);
+        if (static_cast<long long>(casted) != tmp || (tmp < 0 && !boost::is_signed<T>::value))
+            throw bad_value_cast();
+
+        v = casted;
+    }
+};
+
+template<typename T>
+struct typed_fetch_conversion<T, typename boost::enable_if< boost::is_floating_point<T> >::type>
+{
+    static void fetch(backend::result_iface& res, int col, T& v)
+    {
+        double tmp;
+        if (!res.fetch_double(col, tmp))
+            throw null_value_fetch(res.column_to_name(col));
+
+        v = static_cast<T>(tmp);
+    }
+};
+
+template<>
+struct typed_fetch_conversion<std::string, void>
+{
+    static void fetch(backend::result_iface& res, int col, std::string& v)
+    {
+        if (!res.fetch_text(col, v))
+            throw null_value_fetch(res.column_to_name(col));
+    }
+};
+
+/// \cond INTERNAL
+namespace detail {
+
+    template<typename T>
+    struct typed_value
+    {
+        typedef typename boost::remove_cv<typename boost::remove_reference<T>::type>::type type;
+    };
+
+    /// Fetch whole row, scalar types occupy single column
+    template<typename R, typename Enable = void>
+    struct typed_row
+    {
+        static const int columns = 1;
+
+        static void fetch(backend::result_iface& res, R& v)
+        {
+            typed_fetch_conversion<R>::fetch(res, 0, v);
+        }
+    };
+
+    /// Fusion sequences (boost::tuple and adapted structs) occupy one column per element
+    template<typename R>
+    struct typed_row<R, typename boost::enable_if< boost::fusion::traits::is_sequence<R> >::type>
+    {
+        static const int columns = boost::fusion::result_of::size<R>::type::value;
+
+        struct helper
+        {
+            helper(backend::result_iface& res) : res_(res), col_(0) {}
+
+            template<typename T>
+            void operator()(T& v) const
+            {
+                typed_fetch_conversion<T>::fetch(res_, col_++, v);
+            }
+
+            backend::result_iface& res_;
+            mutable int col_;
+        };
+
+        static void fetch(backend::result_iface& res, R& v)
+        {
+            boost::fusion::for_each(v, helper(res));
+        }
+    };
+
+} // namespace detail
+/// \endcond
+
+///
+/// Result of typed_statement query. Rows are fetched directly into \a R.
+///
+template<typename R>
+class typed_result
+{
+    template<typename Signature> friend class typed_statement;
+
+    typed_result(
+        const backend::connection_ptr& conn
+      , const backend::statement_ptr& stmt
+      , const backend::result_ptr& res
+      )
+      : conn_(conn)
+      , stmt_(stmt)
+      , res_(res)
+    {
+        if (res_->cols() < detail::typed_row<R>::columns)
+            throw invalid_column(res_->cols());
+    }
+
+public:
+    /// Move to the next row and fetch it into \a r. Return false if there are no more rows.
+    bool next(R& r)
+    {
+        if (!res_->next())
+            return false;
+
+        detail::typed_row<R>::fetch(*res_, r);
+        return true;
+    }
+
+    /// Return the number of rows in result or boost::uint64_t(-1) if backend doesn`t know it.
+    boost::uint64_t rows()
+    {
+        return res_->rows();
+    }
+
+private:
+    // Note that order of members is not random.
+    // It is very important to destroy result at first, then statement and only then connection
+    backend::connection_ptr conn_;
+    backend::statement_ptr stmt_;
+    backend::result_ptr res_;
+};
+
+/// \brief Statement with parameter and row types fixed at compile time
+///
+/// \a Signature is a function type R(A1, A2, ...) where A1, A2, ... are types of statement parameters
+/// and R is a type of result row. R can be a scalar type for single column results, a boost::tuple or
+/// fusion sequence for multiple columns, or void for statements that don`t return rows.
+/// Parameters and columns are passed through per-type backend functions, without bind_types_variant and
+/// fetch_types_variant.
+///
+/// \code
+/// typedef boost::tuple<std::string, double> user_row;
+/// edba::typed_statement<user_row(int)> st = sess << "select name, balance from users where id = :id";
+/// user_row r = st.first_row(10);
+/// \endcode
+template<typename Signature>
+class typed_statement;
+
+#  define BOOST_PP_ITERATION_PARAMS_1 (3, (0, EDBA_TYPED_STATEMENT_MAX_ARITY, "edba/typed_statement.hpp"))
+#  include BOOST_PP_ITERATE()
+
+}
+
+#  endif        // EDBA_TYPED_STATEMENT_HPP
+
+#else           // !defined(BOOST_PP_IS_ITERATING)
+
+#  define EDBA_TYPED_STATEMENT_PARAM(z, i, data) typename boost::call_traits<A##i>::param_type a##i
+#  define EDBA_TYPED_STATEMENT_BIND(z, i, data) \
+    typed_bind_conversion<typename detail::typed_value<A##i>::type>::bind(*stmt_, i + 1, a##i);
+
+template<typename R BOOST_PP_ENUM_TRAILING_PARAMS(BOOST_PP_ITERATION(), typename A)>
+class typed_statement<R(BOOST_PP_ENUM_PARAMS(BOOST_PP_ITERATION(), A))>
+{
+public:
+    /// Row type
+    typedef R row_type;
+
+    /// Create empty statement, any call except assignment throws empty_statement
+    typed_statement()
+    {
+    }
+
+    /// Create typed statement from ordinary one, usually used as
+    /// \code
+    /// typed_statement<int(int)> st = sess << "select count(*) from test where id > :id";
+    /// \endcode
+    typed_statement(const statement& st)
+      : conn_(st.conn_)
+      , stmt_(st.stmt_)
+    {
+    }
+
+    /// Bind parameters and execute statement
+    void exec(BOOST_PP_ENUM(BOOST_PP_ITERATION(), EDBA_TYPED_STATEMENT_PARAM, ~))
+    {
+        check("exec");
+        stmt_->reset_bindings();
+        BOOST_PP_REPEAT(BOOST_PP_ITERATION(), EDBA_TYPED_STATEMENT_BIND, ~)
+        stmt_->run_exec();
+    }
+
+    /// Bind parameters and execute query
+    typed_result<R> query(BOOST_PP_ENUM(BOOST_PP_ITERATION(), EDBA_TYPED_STATEMENT_PARAM, ~))
+    {
+        check("query");
+        stmt_->reset_bindings();
+        BOOST_PP_REPEAT(BOOST_PP_ITERATION(), EDBA_TYPED_STATEMENT_BIND, ~)
+        return typed_result<R>(conn_, stmt_, stmt_->run_query());
+    }
+
+    /// Bind parameters, execute query and fetch single row.
+    /// Throw empty_row_access if the result is empty and multiple_rows_query if backend knows that
+    /// there are more rows.
+    R first_row(BOOST_PP_ENUM(BOOST_PP_ITERATION(), EDBA_TYPED_STATEMENT_PARAM, ~))
+    {
+        check("first_row");
+        stmt_->reset_bindings();
+        BOOST_PP_REPEAT(BOOST_PP_ITERATION(), EDBA_TYPED_STATEMENT_BIND, ~)
+
+        backend::result_ptr res = stmt_->run_query();
+        if (res->cols() < detail::typed_row<R>::columns)
+            throw invalid_column(res->cols());
+
+        if (!res->next())
+            throw empty_row_access();
+
+        R r;
+        detail::typed_row<R>::fetch(*res, r);
+
+        if (backend::result_iface::next_row_exists == res->has_next())
+            throw multiple_rows_query();
+
+        return r;
+    }
+
+    /// Get the number of affected rows by the last statement
+    unsigned long long affected()
+    {
+        check("affected");
+        return stmt_->affected();
+    }
+
+    /// Get last insert id from the last executed statement, same as statement::last_insert_id()
+    long long last_insert_id()
+    {
+        check("last_insert_id");
+        return stmt_->sequence_last(std::string());
+    }
+
+private:
+    void check(const char* api)
+    {
+        if (!stmt_)
+            throw empty_statement(api);
+    }
+
+    // Note that order of members is not random.
+    // It is very important to destroy statement at first and only then connection
+    backend::connection_ptr conn_;
+    backend::statement_ptr stmt_;
+};
+
+#  undef EDBA_TYPED_STATEMENT_PARAM
+#  undef EDBA_TYPED_STATEMENT_BIND
+
+#endif          // !defined(BOOST_PP_IS_ITERATING)
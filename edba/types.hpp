@@ -11,14 +11,17 @@
 #include <boost/variant/variant.hpp>
 #include <boost/variant/get.hpp>
 #include <boost/cstdint.hpp>
+#include <boost/function.hpp>
 
 #include <string>
+#include <cstddef>
 #include <ctime>
 #include <iosfwd>
 
 namespace edba {
 
 class conn_info;
+class query_handle;
 class session;
 class session_monitor;
 class statement;
@@ -29,14 +32,23 @@ namespace backend {
 struct result_iface;
 struct statement_iface;
 struct connection_iface;
+struct pipeline_iface;
+struct bulk_writer_iface;
+struct blob_iface;
 
 EDBA_ADD_INTRUSIVE_PTR_SUPPORT_FOR_TYPE(result_iface);
 EDBA_ADD_INTRUSIVE_PTR_SUPPORT_FOR_TYPE(statement_iface);
 EDBA_ADD_INTRUSIVE_PTR_SUPPORT_FOR_TYPE(connection_iface);
+EDBA_ADD_INTRUSIVE_PTR_SUPPORT_FOR_TYPE(pipeline_iface);
+EDBA_ADD_INTRUSIVE_PTR_SUPPORT_FOR_TYPE(bulk_writer_iface);
+EDBA_ADD_INTRUSIVE_PTR_SUPPORT_FOR_TYPE(blob_iface);
 
 typedef boost::intrusive_ptr<result_iface> result_ptr;
 typedef boost::intrusive_ptr<statement_iface> statement_ptr;
 typedef boost::intrusive_ptr<connection_iface> connection_ptr;
+typedef boost::intrusive_ptr<pipeline_iface> pipeline_ptr;
+typedef boost::intrusive_ptr<bulk_writer_iface> bulk_writer_ptr;
+typedef boost::intrusive_ptr<blob_iface> blob_ptr;
 
 }
 
@@ -50,6 +62,54 @@ namespace {
 null_type null;
 }
 
+/// Blob of \a size_ zero bytes bound as statement parameter, its content is written later by session::open_blob
+struct zeroblob
+{
+    explicit zeroblob(boost::uint64_t size) : size_(size) {}
+
+    boost::uint64_t size_;
+};
+
+/// How query results are transferred from database server
+enum result_mode
+{
+    buffered_result,    ///< Whole result is loaded into client memory before the first row is returned
+    streamed_result     ///< Rows are received on demand, memory usage doesn`t depend on result size
+};
+
+/// How strings bound to statement are passed to database client library
+enum bind_mode
+{
+    copied_bind,        ///< Bound strings are copied, so they may be destroyed right after binding
+    static_bind         ///< Caller guarantees that bound strings outlive execution, backends that support it don`t copy them
+};
+
+/// Data format used by bulk_writer and session::copy_to
+enum bulk_format
+{
+    bulk_text_format,   ///< Values are sent as text, works for all column types
+    bulk_binary_format  ///< Values are sent in backend specific binary format, faster but supports fewer column types
+};
+
+/// Receiver of data exported by session::copy_to, it is called with \a size bytes of data that are valid only during the call
+typedef boost::function<void(const char* data, std::size_t size)> copy_sink;
+
+/// Observer of session::backup_to and session::restore_from called after each copied step with number of remaining
+/// and total pages. It may sleep to throttle copying or throw to abort it.
+typedef boost::function<void(int remaining, int total)> backup_progress;
+
+/// Counters of prepared statements cache kept by each connection
+struct statement_cache_stats
+{
+    statement_cache_stats() : hits_(0), misses_(0), evictions_(0), size_(0), capacity_(0) {}
+
+    unsigned long long hits_;       ///< Number of prepare requests served from cache
+    unsigned long long misses_;     ///< Number of statements prepared by backend
+    unsigned long long evictions_;  ///< Number of least recently used statements dropped from cache
+    std::size_t size_;              ///< Number of statements currently in cache
+    std::size_t capacity_;          ///< Maximum number of cached statements, 0 means unlimited
+};
+
 /// Types natively supported by statement::bind method
 typedef boost::mpl::vector<
     null_type
@@ -1,5 +1,7 @@
 #include <edba/edba.hpp>
 #include <edba/types_support/boost_optional.hpp>
+#include <edba/types_support/boost_tuple.hpp>
+#include <edba/typed_statement.hpp>
 
 #include <boost/optional/optional_io.hpp>
 #include <boost/format.hpp>
@@ -7,6 +9,7 @@
 #include <boost/foreach.hpp>
 #include <boost/timer.hpp>
 #include <boost/scope_exit.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/locale/encoding_utf.hpp>
 #include <boost/locale/encoding.hpp>
 #include <boost/locale/generator.hpp>
@@ -350,6 +353,30 @@ void test_transactions_and_cursors(session sess)
     BOOST_CHECK_EQUAL(txt, "3");
 }
 
+void test_streamed_result(session sess)
+{
+    const char* SELECT_QUERY = "~~select id from test1 order by id~";
+
+    rowset<int> buffered = sess << SELECT_QUERY;
+    std::vector<int> expected(buffered.begin(), buffered.end());
+
+    // Abandon result after the first row, connection must stay usable
+    {
+        statement st = sess << SELECT_QUERY;
+        rowset<int> rs = st.set_result_mode(streamed_result).query();
+        BOOST_CHECK(rs.begin() != rs.end());
+    }
+
+    statement st = sess << SELECT_QUERY;
+    rowset<int> rs = st.set_result_mode(streamed_result).query();
+    std::vector<int> streamed(rs.begin(), rs.end());
+    BOOST_CHECK(expected == streamed);
+
+    // Statement taken from cache is buffered again
+    rowset<int> again = sess << SELECT_QUERY;
+    BOOST_CHECK_EQUAL(boost::distance(again), int(expected.size()));
+}
+
 void test_incorrect_query(session sess)
 {
     // Some backends may successfully compile incorrect statements
@@ -517,6 +544,7 @@ void test(const char* conn_string)
         }
 
         test_transactions_and_cursors(sess);
+        test_streamed_result(sess);
         test_escaping(sess);
         test_utf8(sess);
         test_string_truncation(sess);
@@ -538,16 +566,408 @@ BOOST_AUTO_TEST_CASE(ODBC)
     test("odbc:Driver=" MSSQL_DRIVER "; Server=" SERVER_IP "\\SQLEXPRESS; Database=EDBA; UID=sa;PWD=1;");
 }
 
+BOOST_AUTO_TEST_CASE(ODBCBlockCursor)
+{
+    test("odbc:Driver=" MSSQL_DRIVER "; Server=" SERVER_IP "\\SQLEXPRESS; Database=EDBA; UID=sa;PWD=1;@odbc_block_size=64");
+}
+
+BOOST_AUTO_TEST_CASE(ODBCExecMany)
+{
+    // SQLite ODBC driver from http://www.ch-werner.de/sqliteodbc
+    session sess("odbc:Driver=SQLite3;Database=:memory:;");
+    sess.once() << "create table many(id integer primary key, val real, txt text)" << exec;
+
+    std::vector< boost::tuple<int, double, std::string> > rows;
+    for(int i = 0; i < 3000; ++i)
+        rows.push_back(boost::make_tuple(i, i / 2.0, boost::lexical_cast<std::string>(i)));
+
+    statement ins = sess << "insert into many(id, val, txt) values(:id, :val, :txt)";
+    BOOST_CHECK_EQUAL(ins.exec_many(rows), 3000u);
+
+    std::vector< boost::tuple<int, null_type, null_type> > nulls;
+    nulls.push_back(boost::make_tuple(5000, null, null));
+    nulls.push_back(boost::make_tuple(5001, null, null));
+    BOOST_CHECK_EQUAL(ins.exec_many(nulls), 2u);
+
+    int count = -1;
+    std::string txt;
+    sess << "select count(*) from many" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 3002);
+    sess << "select txt from many where id = 2999" << first_row >> txt;
+    BOOST_CHECK_EQUAL(txt, "2999");
+    sess << "select count(*) from many where txt is null" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 2);
+
+    // Columns are read in any order and many times
+    rowset<> rs = sess << "select id, val, txt from many where id in (1, 5000) order by id";
+    rowset<>::const_iterator r = rs.begin();
+    BOOST_CHECK_EQUAL(r->get<std::string>(2), "1");
+    BOOST_CHECK(!r->is_null(1));
+    BOOST_CHECK_EQUAL(r->get<double>(1), 0.5);
+    BOOST_CHECK_EQUAL(r->get<int>(0), 1);
+    BOOST_CHECK_EQUAL(r->get<std::string>(2), "1");
+    ++r;
+    BOOST_CHECK(r->is_null(2));
+    BOOST_CHECK(r->is_null(1));
+    BOOST_CHECK_EQUAL(r->get<int>(0), 5000);
+
+    // Duplicate key fails the batch
+    BOOST_CHECK_THROW(ins.exec_many(nulls), edba_error);
+
+    // Statement is usable in ordinary way after batch
+    ins << 6000 << 1.5 << "x" << exec;
+    BOOST_CHECK_EQUAL(ins.affected(), 1u);
+}
+
 BOOST_AUTO_TEST_CASE(MySQL)
 {
     test("mysql:host=" SERVER_IP ";database=edba;user=edba;password=1111;");
 }
 
+BOOST_AUTO_TEST_CASE(MySQLBulkWriter)
+{
+    const char* escapes[] = { "backslash", "csv" };
+    BOOST_FOREACH(const char* escape, escapes)
+    {
+        session sess("mysql:host=" SERVER_IP ";database=edba;user=edba;password=1111;opt_local_infile=1;@mysql_load_escape=" + std::string(escape));
+        sess.exec_batch("drop table if exists bulk_test; create table bulk_test(id integer primary key, name text)");
+
+        bulk_writer w = sess.create_bulk_writer("bulk_test", "id, name");
+        for(int i = 0; i < 100; ++i)
+            w.write(boost::make_tuple(i, "quote \" tab\t back\\slash"));
+        w << 100 << null;
+        w.end_row();
+
+        // Duplicate key is skipped
+        w.write(boost::make_tuple(1, "duplicate"));
+
+        BOOST_CHECK_EQUAL(w.finish(), 101u);
+        BOOST_CHECK_EQUAL(w.skipped(), 1u);
+
+        std::string name;
+        sess << "select name from bulk_test where id = 1" << first_row >> name;
+        BOOST_CHECK_EQUAL(name, "quote \" tab\t back\\slash");
+    }
+}
+
 BOOST_AUTO_TEST_CASE(SQLite3)
 {
     test("sqlite3:db=test.db");
 }
 
+BOOST_AUTO_TEST_CASE(SQLite3StatementCache)
+{
+    session sess("sqlite3:db=:memory:;@stmt_cache_size=2");
+
+    statement st1 = sess << "select 1";
+    statement st2 = sess << "select 2";
+    BOOST_CHECK(st1 == (sess << "select 1"));
+
+    // "select 2" is the least recently used one, it should be evicted
+    sess << "select 3";
+    BOOST_CHECK(st1 == (sess << "select 1"));
+    BOOST_CHECK(!(st2 == (sess << "select 2")));
+
+    statement_cache_stats stats = sess.cache_stats();
+    BOOST_CHECK_EQUAL(stats.hits_, 2u);
+    BOOST_CHECK_EQUAL(stats.misses_, 4u);
+    BOOST_CHECK_EQUAL(stats.evictions_, 2u);
+    BOOST_CHECK_EQUAL(stats.size_, 2u);
+    BOOST_CHECK_EQUAL(stats.capacity_, 2u);
+
+    // Evicted statement still can be used by its owner
+    int v = 0;
+    st2 << first_row >> v;
+    BOOST_CHECK_EQUAL(v, 2);
+}
+
+BOOST_AUTO_TEST_CASE(SQLite3QueryHandle)
+{
+    static const query_handle select_val("  ~Sqlite3~select :v~~select 0~  ");
+
+    session sess("sqlite3:db=:memory:");
+
+    int v = 0;
+    statement st = sess << select_val;
+    st << 10 << first_row >> v;
+    BOOST_CHECK_EQUAL(v, 10);
+    BOOST_CHECK(st == (sess << select_val));
+    BOOST_CHECK(st == (sess << "select :v"));
+
+    sess << select_val << 20 << first_row >> v;
+    BOOST_CHECK_EQUAL(v, 20);
+    BOOST_CHECK_EQUAL(sess.cache_stats().hits_, 3u);
+    BOOST_CHECK_EQUAL(sess.cache_stats().misses_, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(SQLite3MemoizedConditionals)
+{
+    const char* select_engine = "~Sqlite3~select 'sqlite'~~select 'other'~";
+    const char* insert_engine =
+        "~Sqlite3~insert into memo(txt) values('sqlite')~~insert into memo(txt) values('other')~;"
+        "~Sqlite3~insert into memo(txt) values('sqlite3')~;";
+
+    session sess("sqlite3:db=:memory:");
+    sess.once() << "create table memo(txt text)" << exec;
+
+    // Second run takes resolution from memoized conditionals and must give the same text
+    for(int i = 0; i < 2; ++i)
+    {
+        std::string txt;
+        statement st = sess << select_engine;
+        st << first_row >> txt;
+        BOOST_CHECK_EQUAL(txt, "sqlite");
+        BOOST_CHECK(st == (sess << "select 'sqlite'"));
+
+        sess.exec_batch(insert_engine);
+    }
+
+    int count = -1;
+    sess << "select count(*) from memo where txt = 'sqlite'" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 2);
+    sess << "select count(*) from memo where txt = 'sqlite3'" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 2);
+    sess << "select count(*) from memo where txt = 'other'" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 0);
+
+    // Overflow memoized statements and batches to force them to be flushed
+    for(int i = 0; i < 1100; ++i)
+    {
+        std::string n = boost::lexical_cast<std::string>(i);
+        int v = -1;
+        sess << "~Sqlite3~select " + n + "~~select -1~" << first_row >> v;
+        BOOST_CHECK_EQUAL(v, i);
+        sess.exec_batch("~Sqlite3~insert into memo(txt) values('" + n + "')~~select -1~;");
+    }
+
+    sess << "select count(*) from memo where txt = '1099'" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 1);
+
+    std::string txt;
+    sess << select_engine << first_row >> txt;
+    BOOST_CHECK_EQUAL(txt, "sqlite");
+
+    sess.exec_batch(insert_engine);
+    sess << "select count(*) from memo where txt = 'sqlite'" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 3);
+    sess << "select count(*) from memo where txt = 'other'" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 0);
+}
+
+BOOST_AUTO_TEST_CASE(SQLite3TypedStatement)
+{
+    session sess("sqlite3:db=:memory:");
+    sess.once() << "create table typed(id integer, num double, txt text)" << exec;
+
+    typed_statement<void(int, double, const std::string&)> ins = sess << "insert into typed(id, num, txt) values(:id, :num, :txt)";
+    ins.exec(1, 1.5, "one");
+    ins.exec(2, 2.5, "two");
+    BOOST_CHECK_EQUAL(ins.affected(), 1u);
+
+    typedef boost::tuple<long long, double, std::string> typed_row;
+    typed_statement<typed_row(int)> sel = sess << "select id, num, txt from typed where id >= :id order by id";
+
+    typed_row r = sel.first_row(2);
+    BOOST_CHECK_EQUAL(r.get<0>(), 2);
+    BOOST_CHECK_EQUAL(r.get<1>(), 2.5);
+    BOOST_CHECK_EQUAL(r.get<2>(), "two");
+
+    typed_result<typed_row> rs = sel.query(0);
+    int count = 0;
+    while(rs.next(r))
+        ++count;
+    BOOST_CHECK_EQUAL(count, 2);
+    BOOST_CHECK_EQUAL(r.get<2>(), "two");
+
+    typed_statement<int()> cnt = sess << "select count(*) from typed";
+    BOOST_CHECK_EQUAL(cnt.first_row(), 2);
+
+    typed_statement<std::string(null_type)> null_txt = sess << "select coalesce(:v, 'null')";
+    BOOST_CHECK_EQUAL(null_txt.first_row(null), "null");
+}
+
+BOOST_AUTO_TEST_CASE(SQLite3ExecMany)
+{
+    session sess("sqlite3:db=:memory:");
+    sess.once() << "create table many(id integer, txt text)" << exec;
+
+    std::vector< boost::tuple<int, std::string> > rows;
+    for(int i = 0; i < 100; ++i)
+        rows.push_back(boost::make_tuple(i, boost::lexical_cast<std::string>(i)));
+
+    statement ins = sess << "insert into many(id, txt) values(:id, :txt)";
+    BOOST_CHECK_EQUAL(ins.exec_many(rows), 100u);
+
+    std::vector<int> ids(3, 1000);
+    BOOST_CHECK_EQUAL(ins.exec_many(ids), 3u);
+
+    int count = -1;
+    std::string txt;
+    sess << "select count(*) from many" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 103);
+    sess << "select txt from many where id = 99" << first_row >> txt;
+    BOOST_CHECK_EQUAL(txt, "99");
+
+    // Statement is usable in ordinary way after batch
+    ins << 2000 << "x" << exec;
+    BOOST_CHECK_EQUAL(ins.affected(), 1u);
+
+    // Failed batch is rolled back as whole
+    sess.once() << "create unique index many_id on many(txt)" << exec;
+    BOOST_CHECK_THROW(ins.exec_many(rows), edba_error);
+    sess << "select count(*) from many" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 104);
+}
+
+BOOST_AUTO_TEST_CASE(SQLite3Blob)
+{
+    session sess("sqlite3:db=:memory:");
+    sess.once() << "create table blobs(id integer, data blob)" << exec;
+
+    std::string data(100000, '\0');
+    for(std::size_t i = 0; i < data.size(); ++i)
+        data[i] = char(i % 251);
+
+    std::istringstream in(data);
+    std::istringstream empty_in;
+    sess << "insert into blobs(id, data) values(:id, :data)" << 1 << &in << exec;
+    sess << "insert into blobs(id, data) values(:id, :data)" << 2 << &empty_in << exec;
+
+    std::string type;
+    sess << "select typeof(data) from blobs where id = 1" << first_row >> type;
+    BOOST_CHECK_EQUAL(type, "blob");
+
+    std::ostringstream out;
+    sess << "select data from blobs where id = 1" << first_row >> out;
+    BOOST_CHECK(out.str() == data);
+
+    // Empty stream is stored as empty blob, not NULL
+    sess << "select typeof(data) from blobs where id = 2" << first_row >> type;
+    BOOST_CHECK_EQUAL(type, "blob");
+}
+
+BOOST_AUTO_TEST_CASE(SQLite3IncrementalBlob)
+{
+    session sess("sqlite3:db=:memory:");
+    sess.once() << "create table blobs(id integer primary key, data blob)" << exec;
+
+    std::string data(100000, '\0');
+    for(std::size_t i = 0; i < data.size(); ++i)
+        data[i] = char(i % 251);
+
+    statement ins = sess << "insert into blobs(data) values(:data)";
+    ins << zeroblob(data.size()) << exec;
+    long long rowid = ins.last_insert_id();
+
+    // Blob is written and read by chunks smaller than whole value
+    std::istringstream in(data);
+    blob w = sess.open_blob("blobs", "data", rowid, true);
+    BOOST_CHECK_EQUAL(w.size(), data.size());
+    BOOST_CHECK_EQUAL(w.write_from(in, 4096), data.size());
+
+    std::ostringstream out;
+    blob r = sess.open_blob("blobs", "data", rowid);
+    BOOST_CHECK_EQUAL(r.read_to(out, 4096), data.size());
+    BOOST_CHECK(out.str() == data);
+
+    char buf[10];
+    BOOST_CHECK_EQUAL(r.read(data.size() - 4, buf, sizeof(buf)), 4u);
+    BOOST_CHECK(std::string(buf, 4) == data.substr(data.size() - 4));
+    BOOST_CHECK_EQUAL(r.read(data.size(), buf, sizeof(buf)), 0u);
+
+    // Blob size can`t be changed and read only blob can`t be written
+    BOOST_CHECK_THROW(w.write(data.size() - 1, buf, 2), edba_error);
+    BOOST_CHECK_THROW(r.write(0, buf, 1), edba_error);
+    BOOST_CHECK_THROW(sess.open_blob("blobs", "data", rowid + 1), edba_error);
+
+    // Zeroblob is regular value for SQL
+    int len = 0;
+    sess << "select length(data) from blobs where id = :id" << rowid << first_row >> len;
+    BOOST_CHECK_EQUAL(len, int(data.size()));
+}
+
+BOOST_AUTO_TEST_CASE(SQLite3StaticBind)
+{
+    session sess("sqlite3:db=:memory:");
+    sess.once() << "create table docs(id integer, body text)" << exec;
+
+    std::string body(100000, 'b');
+    std::string title("title");
+
+    statement ins = sess << "insert into docs(id, body) values(:id, :body)";
+    ins.set_bind_mode(static_bind) << 1 << body << exec;
+    ins.reset_bindings() << 2 << title << exec;
+
+    std::string v;
+    sess << "select body from docs where id = 1" << first_row >> v;
+    BOOST_CHECK(v == body);
+    sess << "select body from docs where id = 2" << first_row >> v;
+    BOOST_CHECK_EQUAL(v, title);
+
+    // Statement taken from cache copies strings again
+    statement cached = sess << "insert into docs(id, body) values(:id, :body)";
+    {
+        std::string tmp("temporary");
+        cached << 3 << tmp;
+    }
+    cached << exec;
+    sess << "select body from docs where id = 3" << first_row >> v;
+    BOOST_CHECK_EQUAL(v, "temporary");
+}
+
+struct backup_steps_counter
+{
+    backup_steps_counter(int& steps) : steps_(&steps) {}
+
+    void operator()(int remaining, int total) const
+    {
+        BOOST_CHECK_LE(remaining, total);
+        ++*steps_;
+    }
+
+    int* steps_;
+};
+
+BOOST_AUTO_TEST_CASE(SQLite3Backup)
+{
+    {
+        session file("sqlite3:db=test_backup.db");
+        file.once() << "drop table if exists backup_test" << exec;
+        file.once() << "create table backup_test(id integer, txt text)" << exec;
+        for(int i = 0; i < 100; ++i)
+            file << "insert into backup_test(id, txt) values(:id, :txt)" << i << std::string(1000, 'x') << exec;
+    }
+
+    session mem("sqlite3:db=:memory:");
+
+    int steps = 0;
+    mem.restore_from("test_backup.db", 10, backup_steps_counter(steps));
+    BOOST_CHECK_GT(steps, 1);
+
+    int count = 0;
+    mem << "select count(*) from backup_test" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 100);
+
+    mem << "delete from backup_test where id >= 50" << exec;
+    mem.backup_to("test_backup.db");
+
+    session file("sqlite3:db=test_backup.db");
+    file << "select count(*) from backup_test" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 50);
+
+    BOOST_CHECK_THROW(mem.restore_from("no_such_dir/test_backup.db"), edba_error);
+
+    // Backup gives up when database stays locked longer than busy timeout
+    session waiting("sqlite3:db=:memory:;@sqlite_busy_timeout=300");
+    file.once() << "begin exclusive" << exec;
+    BOOST_CHECK_THROW(waiting.restore_from("test_backup.db"), edba_error);
+    file.once() << "commit" << exec;
+
+    waiting.restore_from("test_backup.db");
+    waiting << "select count(*) from backup_test" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 50);
+}
+
 BOOST_AUTO_TEST_CASE(Postgresql)
 {
     test("postgresql:user=postgres; password=1; host=" SERVER_IP "; port=5432; dbname=test;");
@@ -558,3 +978,121 @@ BOOST_AUTO_TEST_CASE(PostgresqlLo)
     test("postgresql:user=postgres; password=1; host=" SERVER_IP "; port=5432; dbname=test; @blob=lo");
 }
 
+BOOST_AUTO_TEST_CASE(PostgresqlPipeline)
+{
+    session sess("postgresql:user=postgres; password=1; host=" SERVER_IP "; port=5432; dbname=test;");
+    sess.exec_batch("drop table if exists pipeline_test; create table pipeline_test(id integer primary key)");
+
+    pipeline p(sess);
+    statement ins = sess << "insert into pipeline_test(id) values(:id)";
+    for(int i = 0; i < 10; ++i)
+        p.exec(ins << i);
+
+    statement sel = sess << "select count(*) from pipeline_test";
+    std::size_t cnt = p.query(sel);
+    p.sync();
+
+    BOOST_CHECK_EQUAL(p.affected(0), 1u);
+    int count = 0;
+    p.result(cnt).begin()->fetch(0, count);
+    BOOST_CHECK_EQUAL(count, 10);
+
+    // Duplicate key fails second statement, the rest are skipped
+    p.exec(ins << 100);
+    std::size_t dup = p.exec(ins << 1);
+    std::size_t skipped = p.exec(ins << 101);
+
+    try
+    {
+        p.sync();
+        BOOST_ERROR("pipeline_error expected");
+    }
+    catch(const pipeline_error& e)
+    {
+        BOOST_CHECK_EQUAL(e.index(), dup);
+    }
+
+    BOOST_CHECK(!p.error(skipped).empty());
+    BOOST_CHECK_THROW(p.affected(skipped), pipeline_error);
+}
+
+BOOST_AUTO_TEST_CASE(SQLite3PipelineNotSupported)
+{
+    session sess("sqlite3:db=:memory:");
+    BOOST_CHECK_THROW(pipeline p(sess), not_supported_by_backend);
+}
+
+BOOST_AUTO_TEST_CASE(PostgresqlBulkWriter)
+{
+    session sess("postgresql:user=postgres; password=1; host=" SERVER_IP "; port=5432; dbname=test;");
+    sess.exec_batch(
+        "drop table if exists bulk_test; create table bulk_test(id integer, name text, amount float8);"
+        "drop table if exists bulk_json; create table bulk_json(id integer, doc jsonb)");
+
+    bulk_format formats[] = { bulk_text_format, bulk_binary_format };
+    BOOST_FOREACH(bulk_format f, formats)
+    {
+        bulk_writer w = sess.create_bulk_writer("bulk_test", "id, name, amount", f);
+        for(int i = 0; i < 1000; ++i)
+            w.write(boost::make_tuple(i, "tab\tand\nnew line", i * 0.5));
+        w << 1000 << null << 1.5;
+        w.end_row();
+        BOOST_CHECK_EQUAL(w.finish(), 1001u);
+
+        // jsonb has version prefix in binary format only
+        bulk_writer jw = sess.create_bulk_writer("bulk_json", "id, doc", f);
+        jw.write(boost::make_tuple(static_cast<int>(f), "{\"key\": \"value\"}"));
+        BOOST_CHECK_EQUAL(jw.finish(), 1u);
+    }
+
+    int count = 0;
+    sess << "select count(*) from bulk_test where name = 'tab\tand\nnew line'" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 2000);
+    sess << "select count(*) from bulk_json where doc->>'key' = 'value'" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 2);
+
+    // Cancelled loading leaves table untouched
+    {
+        bulk_writer w = sess.create_bulk_writer("bulk_test");
+        w.write(boost::make_tuple(1, "cancelled", 0.0));
+    }
+    sess << "select count(*) from bulk_test" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 2002);
+}
+
+struct copy_row_counter
+{
+    copy_row_counter(int& rows) : rows_(&rows) {}
+
+    void operator()(const char*, std::size_t) const
+    {
+        ++*rows_;
+    }
+
+    int* rows_;
+};
+
+BOOST_AUTO_TEST_CASE(PostgresqlCopyTo)
+{
+    session sess("postgresql:user=postgres; password=1; host=" SERVER_IP "; port=5432; dbname=test;");
+
+    std::ostringstream out;
+    BOOST_CHECK_EQUAL(sess.copy_to("select i, 'a\tb' from generate_series(1, 3) as i", out), 3u);
+    BOOST_CHECK_EQUAL(out.str(), "1\ta\\tb\n2\ta\\tb\n3\ta\\tb\n");
+
+    int rows = 0;
+    BOOST_CHECK_EQUAL(sess.copy_to("select i from generate_series(1, 100000) as i", copy_row_counter(rows)), 100000u);
+    BOOST_CHECK_EQUAL(rows, 100000);
+
+    // Connection stays usable after failed export
+    BOOST_CHECK_THROW(sess.copy_to("select 1/0", out), edba_error);
+    int one = 0;
+    sess << "select 1" << first_row >> one;
+    BOOST_CHECK_EQUAL(one, 1);
+}
+
+BOOST_AUTO_TEST_CASE(PostgresqlBinaryResults)
+{
+    test("postgresql:user=postgres; password=1; host=" SERVER_IP "; port=5432; dbname=test; @result_format=binary");
+}
+
@@ -115,3 +115,73 @@ BOOST_AUTO_TEST_CASE(SessionPoolODBC)
     run_pool_test("odbc:Driver={SQL Server Native Client 10.0}; Server=edba-test\\SQLEXPRESS; Database=EDBA; UID=sa;PWD=1;");
 }
 
+
+void reader_proc(session_pool& pool, boost::atomic<size_t>& rows_read, boost::atomic<bool>& failed)
+{
+    try
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            rowset<int> rs = pool.open_reader() << "select id from wal_test";
+
+            BOOST_FOREACH(int id, rs)
+            {
+                if (id < 0)
+                    failed = true;
+                rows_read++;
+            }
+        }
+    }
+    catch(...)
+    {
+        failed = true;
+        cerr << "Reader from pool failed: " << boost::current_exception_diagnostic_information() << endl;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SessionPoolSqlite3Readers)
+{
+    session_pool pool(
+        "sqlite3:db=test_wal.db;@sqlite_wal=on;@sqlite_nomutex=on", 1
+      , "sqlite3:db=test_wal.db;mode=readonly;@sqlite_nomutex=on", DB_POOL_SIZE
+      );
+
+    {
+        session writer = pool.open();
+        writer.once() << "drop table if exists wal_test" << exec;
+        writer.once() << "create table wal_test(id integer)" << exec;
+
+        std::string journal_mode;
+        writer << "pragma journal_mode" << first_row >> journal_mode;
+        BOOST_CHECK_EQUAL(journal_mode, "wal");
+
+        // The only writer is busy
+        session other;
+        BOOST_CHECK(!pool.try_open(other));
+
+        // Readers always have something to read even if they finish before the following inserts
+        for (int i = 0; i < 10; ++i)
+            writer << "insert into wal_test(id) values(:id)" << i << exec;
+    }
+
+    boost::atomic<size_t> rows_read(size_t(0));
+    boost::atomic<bool> readers_failed(false);
+    boost::thread_group tg;
+    for(size_t i = 0; i < THREAD_POOL_SIZE; ++i)
+        tg.create_thread(boost::bind(reader_proc, boost::ref(pool), boost::ref(rows_read), boost::ref(readers_failed)));
+
+    // Readers work concurrently with writer
+    for (int i = 10; i < 110; ++i)
+        pool.open() << "insert into wal_test(id) values(:id)" << i << exec;
+
+    tg.join_all();
+
+    BOOST_CHECK(!readers_failed);
+    BOOST_CHECK_GT(rows_read, 0u);
+
+    int count = 0;
+    pool.open_reader() << "select count(*) from wal_test" << first_row >> count;
+    BOOST_CHECK_EQUAL(count, 110);
+
+    BOOST_CHECK_THROW(pool.open_reader().once() << "insert into wal_test(id) values(0)" << exec, edba_error);
+}